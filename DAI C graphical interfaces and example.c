@@ -3,10 +3,16 @@
 //====================================================================================
 // REMARKS
 // 1) Mandelbrot requires to be compiled with mbf32 math library due to insufficient precision of dai32 library
-// Command line example : zcc.exe +dai -m -v -s -create-app --list --math-mbf32 -Cz--loud a.c >> a.txt
+// Command line example : zcc.exe +dai -m -v -s -create-app --list --math-mbf32 -Cz--loud a.c @libdai/dai.lst >> a.txt
+// (or -Llibdai -ldai instead of @libdai/dai.lst once the library is built, see libdai/dai.h)
+// mandelbrot_fx uses 4.12 fixed point integers and does not need any math library :
+// comment MANDELBROT_DOUBLE below and remove --math-mbf32 from the command line
 // 2) Static variables may be required for some programs due to stack limited size (128 bytes)
 // This is the case for example when using printf (which requires some delay to let charracter be processed)
+// dai_puts and dai_print_uint write characters directly in screen memory and need no delay
 // If necessary, stack pointer (SP) can be move to an other memory position
+// 3) tools/dai_host.c builds this file for Linux with DAI_HOST (dai_* functions drawn in memory
+// and saved as PNG) : assembly functions have C versions and demos return instead of waiting
 
 
 //====================================================================================
@@ -14,6 +20,20 @@
 //====================================================================================
 #include <stdint.h>
 #include <stdio.h>
+#include "libdai/dai.h" // dai_* functions, options DAI_VDRAW_NATIVESLOPES and DAI_BACKBUFFER
+
+
+//====================================================================================
+// Compilation options
+//====================================================================================
+#define MANDELBROT_DOUBLE // Comment to remove floating point mandelbrot() and mbf32 library
+// #define MANDELBROT_FASTREJECT // Uncomment to skip iterations of points inside main cardioid, period 2 bulb or on a periodic orbit
+// #define MANDELBROT_PROGRESSIVE // Uncomment to render a preview with blocks of 8, then 4, 2 and 1 dots
+// #define MANDELBROT_CHECKPOINT // Uncomment to save the state of mandelbrot and mandelbrot_fx in RAM (CK_ADDR) and resume after a break
+// #define MANDELBROT_KCACHE // Uncomment to keep iteration counts in RAM (MK_ADDR) and recolor without computing again
+// #define DAI_PROFILE // Uncomment to sample the program counter on interrupts and count probes (see tools/dai_prof.c)
+// #define ET_KERNEL ET_JULIA // Kernel of et_render : ET_MANDELBROT (default), ET_JULIA or ET_BURNINGSHIP
+// #define ET_NUMBER ET_FX88 // Numbers of et_render : ET_FX412 (default), ET_FX88 or ET_MBF32 (requires MANDELBROT_DOUBLE)
 
 
 //====================================================================================
@@ -24,27 +44,54 @@
 // Function for test
 // -----------------------------------------------------------------------------------
 void mandelbrot(void); // Mandelbrot fractal graphic, around 4 hours to run, can be stopped using a lon push on break key
+uint8_t mandelbrot_iter(uint16_t x, uint8_t y); // Iterations of a point with floating point (mbf32)
+void mandelbrot_fx(void); // Same Mandelbrot with 4.12 fixed point integers, no math library required
+void mandelbrot_ms(void); // Same as mandelbrot_fx, computes only borders of areas with the same color
+void mandelbrot_fx_init(void); // Coordinates tables of fixed point renderers
+uint8_t mandelbrot_fx_color(uint16_t x, uint8_t y); // Color of a point with fixed point integers
+uint8_t mandelbrot_fx_iter(uint16_t x, uint8_t y); // Iterations of a point with fixed point integers
+void mandelbrot_kinit(uint16_t cols, uint8_t top, uint8_t max); // Start a new image in the iteration counts cache
+uint8_t *mandelbrot_krow(uint8_t y); // Iteration counts of row y (index x), 0 if not cached
+void mandelbrot_recolor(uint8_t *lut); // Plot again cached rows with colors lut[iterations]
+void mandelbrot_recolor_demo(void); // Recolor with moving thresholds, does not exit
+uint8_t mandelbrot_ckarea(void); // Check that the checkpoint block is above the program
+uint8_t mandelbrot_ckstart(uint8_t id, uint8_t m, uint8_t max, uint16_t cols, uint8_t top, int16_t *win); // Resume or start a checkpointed render
+void mandelbrot_ckrow(uint8_t step, uint8_t y); // Save the next row to compute
+void mandelbrot_ckdone(void); // Render finished, nothing to resume
+void mandelbrot_resume(void); // Continue an interrupted render, returns if there is none
+void mandelbrot_ms_dot(uint16_t x, uint8_t y); // Compute and plot a dot and its mirror
+void mandelbrot_progressive(uint8_t (*iter)(uint16_t x, uint8_t y), uint8_t *lut, uint16_t cols, uint8_t top); // Coarse to fine rendering
 void test_graphics(void); // Plot some simple graphic figures
 void test_texts (void); // In text mode, change color and move cursor
+void test_tasks(void); // Mandelbrot_fx as a task with a status line, space bar pauses
+uint8_t mandelbrot_fx_task(uint16_t *pt); // Mandelbrot_fx yielding after each row
+uint8_t status_task(uint16_t *pt); // Keyboard and status line of test_tasks
+void test_escape(void); // Windows of the escape time engine, one after the other
+void test_shapes(void); // Gauges and charts drawn with circles, arcs and ellipses
+void test_fills(void); // Filled polygons and flood fill of areas bounded by lines and curves
+void test_sprites(void); // A ball moving over stripes, drawn with dai_blit and put back with dai_unblit
 
 // -----------------------------------------------------------------------------------
-// Functions to emulate Dai basic commands
+// Escape time engine (kernel and numbers chosen at compile time, see ET_KERNEL and ET_NUMBER)
 // -----------------------------------------------------------------------------------
-// differences from basic commands : no error is returned 
-void dai_mode(uint8_t m); // change graphic modes
-void dai_colorg(uint8_t C0,uint8_t C1,uint8_t C2,uint8_t C3); // Default graphic colors for 4 color mode
-void dai_dot(uint16_t x, uint8_t y, uint8_t c); // Plot a dot
-void dai_draw(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint8_t c); // Plot a line
-void dai_fill(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint8_t c); // Plot a rectangle
-uint16_t dai_xmax(void); // Get max x of current graphic mode
-uint8_t dai_ymax(void); // Get max y of current graphic mode
-uint8_t dai_scrn(uint8_t x, uint8_t y);  // Get color of a dot in graphic mode
+void et_render(int16_t *win, uint8_t m, uint8_t *colors, uint8_t max, uint8_t t1, uint8_t t2); // Fractal of window win in mode m
+void et_init(int16_t *win, uint16_t cols, uint8_t top); // Internal, coordinates of columns and rows
+uint8_t et_iter(uint16_t x, uint8_t y); // Iterations of the dot of column x and row y
 
-void dai_colort(uint8_t C0,uint8_t C1,uint8_t C2,uint8_t C3); // Default text colors
-void dai_cursor(uint8_t x, uint8_t y); // Set cursor position in text mode
-void dai_clearscreen(void); // Clear screen in text mode by sending charater 0x12 
-uint8_t dai_curx(void); // Get cursor x position in text mode
-uint8_t dai_cury(void); // Get cursor y position in text mode
+// -----------------------------------------------------------------------------------
+// Fixed point 4.12 arithmetic (1.0 = 4096)
+// -----------------------------------------------------------------------------------
+int16_t fx_mul(int16_t a, int16_t b); // a*b, |a| and |b| lower than 2.0
+int16_t fx_mul2(int16_t a, int16_t b); // 2*a*b, |a| and |b| lower than 2.0
+int16_t fx_sqr(int16_t a); // a*a, |a| lower than 2.0
+void fx_mulcore(void); // Internal, registers interface : hl = bc*de (see function)
+
+
+// -----------------------------------------------------------------------------------
+// Cooperative tasks (protothreads)
+// -----------------------------------------------------------------------------------
+uint8_t task_add(uint8_t (*f)(uint16_t *pt)); // Add a task, returns 0 if the table is full
+void task_run(void); // Run tasks in turn until all of them are done
 
 
 // -----------------------------------------------------------------------------------
@@ -53,19 +100,168 @@ uint8_t dai_cury(void); // Get cursor y position in text mode
 void savereg_x2000(void); // Save registers at 0x2000
 void savereg_x2010(void); // Save registers at 0x2010
 uint16_t get_SP(void); // Return SP to check for stack overflow
+uint16_t prog_end(void); // Return the first byte after the program (code, data and BSS)
 void change_Stack(void); // Example to execute function requiring larger stack 
 
 
+// -----------------------------------------------------------------------------------
+// Profiling (program counter histogram and probes in a reserved RAM area)
+// -----------------------------------------------------------------------------------
+#ifdef DAI_PROFILE
+uint8_t prof_start(uint16_t lo, uint8_t shift); // Start sampling from address lo, bins of 2^shift bytes
+void prof_stop(void); // Stop sampling, results stay in the RAM area
+void prof_isr(void); // Internal, interrupt handler chained before the ROM one
+#endif
+
+
+//====================================================================================
+// Global variables
+//====================================================================================
+
+// -----------------------------------------------------------------------------------
+// Cooperative tasks (protothreads)
+// -----------------------------------------------------------------------------------
+// A task is a function uint8_t f(uint16_t *pt) run again and again by task_run until it
+// returns PT_DONE. Its body is between PT_BEGIN and PT_END, PT_YIELD and PT_WAIT_UNTIL
+// return to task_run, *pt keeps the line to continue from at next call.
+// Tasks have no stack of their own : their variables must be static, PT_ macros can not
+// be used inside a switch of the task and two of them can not be on the same line
+#define TASK_MAX 4 // Tasks run by task_run
+#define PT_WAITING 0
+#define PT_DONE 1
+#define PT_BEGIN(pt) switch (*(pt)) { case 0:
+#define PT_YIELD(pt) { *(pt) = __LINE__; return PT_WAITING; case __LINE__: ; }
+#define PT_WAIT_UNTIL(pt, c) while (!(c)) PT_YIELD(pt) // yields only while c is false
+#define PT_END(pt) } *(pt) = 0; return PT_DONE;
+
+// End of a demo : waits for break on the DAI, returns in the host build (tools/dai_host.c)
+// DEMO_KEY : between two steps of a demo, waits for a key to be released then pressed,
+// does not wait in the host build
+#ifdef DAI_HOST
+#define DEMO_END() return
+#define DEMO_KEY()
+#else
+#define DEMO_END() while(1)
+#define DEMO_KEY() { while (getk()) {} while (!getk()) {} }
+#endif
+
+uint8_t (*task_fn[TASK_MAX])(uint16_t *pt); // 0 for a free entry
+uint16_t task_pt[TASK_MAX]; // Line to continue from of each task
+uint16_t task_ticks = 0; // Rounds of task_run
+uint8_t task_row; // Row computed by mandelbrot_fx_task, 0 when done
+uint8_t task_pause = 0; // 1 to stop mandelbrot_fx_task
+
+
+// -----------------------------------------------------------------------------------
+// Profiling area and probes
+// -----------------------------------------------------------------------------------
+// Area layout (32 bits counters) :
+// +0 'P','F' ; +2 lo ; +4 shift ; +5 number of probes ; +8 samples ; +12 samples out of bins
+// +16 256 bins of 2^shift bytes from lo ; +1040 calls of probes ; then samples of probes
+// Probe samples are the samples taken between enter and exit (inclusive)
+// Dump the area to analyse it on the host with tools/dai_prof.c
+#ifdef DAI_PROFILE
+#define PROF_AREA 0x3000 // Reserved RAM area, 1040 + 8 * PROF_PROBES bytes, above the program (see prof_start)
+#define PROF_VECTOR 0x0038 // Restart vector of the timer interrupt, must hold a jp to the ROM handler
+#define PROF_LO 0x0800 // Default start of bins (G0800)
+#define PROF_SHIFT 6 // Default bins of 64 bytes, 16 KB
+
+// Probes : names given to dai_prof with -n iter,plot,border,fill
+#define PROF_ITER 0 // Iterations of a point
+#define PROF_PLOT 1 // Plot of computed points
+#define PROF_BORDER 2 // Border check of mandelbrot_ms
+#define PROF_FILL 3 // Fills of mandelbrot_ms
+#define PROF_PROBES 4
+
+#define PROF_SAMPLES (*(uint32_t *)(PROF_AREA + 8))
+#define PROF_CALLS ((uint32_t *)(PROF_AREA + 1040))
+#define PROF_TICKS (PROF_CALLS + PROF_PROBES)
+#define PROF_ENTER(n) { if (prof_on) { PROF_CALLS[n]++; prof_t0[n] = PROF_SAMPLES; } }
+#define PROF_EXIT(n) { if (prof_on) PROF_TICKS[n] += PROF_SAMPLES - prof_t0[n]; }
+
+uint8_t *prof_area = (uint8_t *)PROF_AREA; // Read by prof_isr
+uint16_t prof_lo; // Address of first bin
+uint8_t prof_shift; // Size of bins : 2^shift bytes
+uint16_t prof_old; // ROM interrupt handler
+uint32_t prof_t0[PROF_PROBES]; // Samples when probes were entered
+uint8_t prof_on = 0; // 1 once prof_start has cleared the area, probes do nothing before
+#else
+#define PROF_ENTER(n)
+#define PROF_EXIT(n)
+#endif
+
+
+// -----------------------------------------------------------------------------------
+// Iteration counts cache, filled by mandelbrot and mandelbrot_fx
+// -----------------------------------------------------------------------------------
+// One byte per dot of the lower half (the upper half is its mirror), row by row from row 1
+// The whole default image needs 335 * 127 = 42545 bytes, more than the RAM left by the
+// screen of mode 0x0A : only the first rows are cached (all of them with a reduced window,
+// ex: FX_XMAX 143 and FX_YMAX 127 need 143 * 63 = 9009 bytes)
+// The cache goes from MK_ADDR up to MK_SIZE bytes, but never reaches the screen memory :
+// mandelbrot_kinit is called once the mode is set and stops the cache below dai_vlow
+// (tools/dai_host.c built with -DMANDELBROT_KCACHE : screen memory of mode 0x0A starts at 0x646E,
+// 0x246E bytes, 27 rows of 335 columns)
+#ifdef MANDELBROT_KCACHE
+#define MK_ADDR 0x4000 // Cache in RAM, above the program
+#define MK_SIZE 0x2800 // Max bytes of the cache, less if the screen memory is lower
+
+uint8_t *mk_buf = DAI_ADDR(MK_ADDR);
+uint16_t mk_xmax; // Columns 1 to mk_xmax
+uint8_t mk_ymax; // Row y is mirrored on row mk_ymax - y
+uint8_t mk_rows; // Rows 1 to mk_rows are cached
+uint8_t mk_max; // Iterations of points of the set
+#endif
+
+
+// -----------------------------------------------------------------------------------
+// Checkpoint of mandelbrot and mandelbrot_fx
+// -----------------------------------------------------------------------------------
+// Block layout :
+// +0 'C','K' ; +2 renderer (1 mandelbrot, 2 mandelbrot_fx) ; +3 max iterations ; +4 xmax (16 bits)
+// +6 ymax ; +7 step of mandelbrot_progressive (0 row by row) ; +8 next row ; +10 window in
+// thousandths (4 x 16 bits)
+// The block is updated before each row, so a render stopped with break (or a crash which
+// does not overwrite it) continues from the row being computed when the program is run again
+// CK_ADDR must be above the program (see the .map) : if the program goes past it, the block
+// is kept in ck_ram, renders still work but there is nothing to resume after a break
+#ifdef MANDELBROT_CHECKPOINT
+#define CK_ADDR 0x3F00 // Reserved RAM block, 18 bytes, above the program (see mandelbrot_ckarea)
+#define CK_SIZE 18
+#define CK_COLS (*(uint16_t *)(ck_area + 4))
+#define CK_WIN ((int16_t *)(ck_area + 10))
+
+uint8_t *ck_area = (uint8_t *)CK_ADDR;
+uint8_t ck_ram[CK_SIZE]; // Block used when CK_ADDR is inside the program
+uint8_t ck_resume = 0; // 1 while mandelbrot_resume runs a renderer
+uint8_t ck_step; // State to start from, set by mandelbrot_ckstart
+uint8_t ck_y;
+#endif
+
+
 //====================================================================================
 // Main
 //====================================================================================
 // Uncomment desired example function  
 void main()
 {
+#ifdef DAI_PROFILE
+	prof_start(PROF_LO, PROF_SHIFT);
+#endif
+#ifdef MANDELBROT_CHECKPOINT
+	mandelbrot_resume(); // continue an interrupted render, returns if there is none
+#endif
 
 	// mandelbrot(); 
+	// mandelbrot_fx(); 
+	// mandelbrot_ms(); 
 	test_graphics ();
 	// test_texts();
+	// test_tasks();
+	// test_escape();
+	// test_shapes();
+	// test_fills();
+	// test_sprites();
 }
 
 
@@ -75,12 +271,21 @@ void main()
 // Create Mandelbrot fractal (takes 4 hours) with 4 colors in the largest DAI definiion
 // Static variables are used essentially to avoid stack overflow
 // Requires to be compiled with mbf32 math library due to insufficient precision of dai32 library
+// With MANDELBROT_PROGRESSIVE, rendered by mandelbrot_progressive (preview in a few minutes)
 // Does not exit
 // On a DAI can exit with a long push on break
+#ifdef MANDELBROT_DOUBLE
+double md_g, md_h; // size of a dot
+
 void mandelbrot(void)
 {
+#ifdef MANDELBROT_XMAX // reduced window, ex: zcc ... -DMANDELBROT_XMAX=83 -DMANDELBROT_YMAX=63
+	#define xmax MANDELBROT_XMAX
+	#define ymax MANDELBROT_YMAX
+#else
 	#define xmax 335
 	#define ymax 255
+#endif
 	#define MAX_ITERATIONS 45 
 	#define L_COLOR1 12
 	#define L_COLOR2 7
@@ -96,45 +301,83 @@ void mandelbrot(void)
 
 	#define e (4.0) 
 
-    static double g, h, i, j;
-    static uint16_t x, color ;
-    static uint8_t y, k ;
-    static double l, m, n, o, p;
+    static uint8_t k ;
+    static uint8_t lut[MAX_ITERATIONS + 1]; // color of each number of iterations
+#ifndef MANDELBROT_PROGRESSIVE
+    static uint16_t x ;
+    static uint8_t y ;
+    static uint8_t line[xmax + 1]; // colors of current row
+#ifdef MANDELBROT_KCACHE
+    static uint8_t *kr;
+#endif
+#endif
+#ifdef MANDELBROT_CHECKPOINT
+    static int16_t win[4];
+#endif
 
 	dai_colorg(Colorg0,Colorg1,Colorg2,Colorg3); 
+	for (k = 0; k <= MAX_ITERATIONS; k++)
+		lut[k] = (k==MAX_ITERATIONS?Colorg3:(k>L_COLOR1?Colorg2:(k>L_COLOR2?Colorg1:Colorg0))) ;
+#ifdef MANDELBROT_CHECKPOINT
+	win[0] = (int16_t)(a0 * 1000.0);
+	win[1] = (int16_t)(b0 * 1000.0);
+	win[2] = (int16_t)(c0 * 1000.0);
+	win[3] = (int16_t)(d0 * 1000.0);
+	k = mandelbrot_ckstart(1, 0x0A, MAX_ITERATIONS, xmax, ymax, win);
+	if (k != 1) dai_mode (0x0A); // screen lost or new render
+#else
 	dai_mode (0x0A);
-
-    g = (b0 - a0) / (double)xmax;
-    h = (d0 - c0) / (double)ymax;
-
+#endif
+#ifdef MANDELBROT_KCACHE
+	mandelbrot_kinit(xmax, ymax, MAX_ITERATIONS); // mode set : cache below its screen memory
+#ifdef MANDELBROT_CHECKPOINT
+	if (k == 2) {
+		if (mk_rows >= ymax / 2) mandelbrot_recolor(lut); // completed rows from the cache
+		else mandelbrot_ckstart(1, 0x0A, MAX_ITERATIONS, xmax, ymax, win); // not all cached : new render
+	}
+#endif
+#endif
+
+    md_g = (b0 - a0) / (double)xmax;
+    md_h = (d0 - c0) / (double)ymax;
+
+#ifdef MANDELBROT_PROGRESSIVE
+	mandelbrot_progressive(mandelbrot_iter, lut, xmax, ymax);
+#else
+#ifdef MANDELBROT_CHECKPOINT
+	y = ck_y ;
+#else
 	y = ymax / 2 ;
+#endif
     do{
-        j = (double)y * h + c0;
+#ifdef MANDELBROT_CHECKPOINT
+		mandelbrot_ckrow(0, y);
+#endif
+#ifdef MANDELBROT_KCACHE
+		kr = mandelbrot_krow(y);
+#endif
 		x = xmax;
         do {
-            i = (double)x * g + a0;
-            k = 0;
-            l = 0.0;
-            m = 0.0;
-            n = 0.0;
-            o = 0.0;
-            while ((k < MAX_ITERATIONS) & ((n + o) < e) ) //Iterates
-            {
-                p = n - o + i;
-                m = 2.0 * l * m + j;
-                l = p;
-                n = l * l;
-                o = m * m;
-				k++;
-            }
-			color = (k==MAX_ITERATIONS?Colorg3:(k>L_COLOR1?Colorg2:(k>L_COLOR2?Colorg1:Colorg0))) ;
-
-			dai_dot((uint16_t)x,  y, (uint8_t) color);
-			dai_dot((uint16_t)x, (ymax - y), (uint8_t) color) ;
+            PROF_ENTER(PROF_ITER);
+            k = mandelbrot_iter(x, y);
+            PROF_EXIT(PROF_ITER);
+#ifdef MANDELBROT_KCACHE
+			if (kr) kr[x] = k;
+#endif
+
+			line[x] = lut[k];
 			x-- ;
         } while (x!=0) ;
+		PROF_ENTER(PROF_PLOT);
+		dai_dots(1, y, xmax, &line[1]);
+		dai_dots(1, (ymax - y), xmax, &line[1]);
+		PROF_EXIT(PROF_PLOT);
 		y--;
     } while (y!=0) ;
+#endif
+#ifdef MANDELBROT_CHECKPOINT
+	mandelbrot_ckdone();
+#endif
 
 	// Draw a border
 	dai_draw(0,0, 0, ymax, Colorg3) ;
@@ -142,7 +385,880 @@ void mandelbrot(void)
 	dai_draw(xmax,0, xmax, ymax, Colorg3) ;
 	dai_draw(xmax,0, 0, 0, Colorg3) ;
 	
-	while(1); 
+#ifdef MANDELBROT_KCACHE
+	mandelbrot_recolor_demo();
+#endif
+	DEMO_END();
+}
+
+
+// -----------------------------------------------------------------------------------
+// Mandelbrot_iter
+// -----------------------------------------------------------------------------------
+// Iterate the point of column x and row y with floating point (parameters of mandelbrot)
+// Returns the number of iterations, MAX_ITERATIONS for points of the set
+uint8_t mandelbrot_iter(uint16_t x, uint8_t y)
+{
+    static double i, j;
+    static uint8_t k ;
+    static double l, m, n, o, p;
+#ifdef MANDELBROT_FASTREJECT
+    static double q, pl, pm;
+    static uint8_t pk;
+#endif
+
+    i = (double)x * md_g + a0;
+    j = (double)y * md_h + c0;
+    k = 0;
+    l = 0.0;
+    m = 0.0;
+    n = 0.0;
+    o = 0.0;
+#ifdef MANDELBROT_FASTREJECT
+    // Main cardioid and period 2 bulb never escape
+    q = (i - 0.25) * (i - 0.25) + j * j;
+    if ((q * (q + (i - 0.25)) < 0.25 * j * j) | ((i + 1.0) * (i + 1.0) + j * j < 0.0625)) k = MAX_ITERATIONS;
+    pl = 0.0;
+    pm = 0.0;
+    pk = 1;
+#endif
+    while ((k < MAX_ITERATIONS) & ((n + o) < e) ) //Iterates
+    {
+        p = n - o + i;
+        m = 2.0 * l * m + j;
+        l = p;
+        n = l * l;
+        o = m * m;
+        k++;
+#ifdef MANDELBROT_FASTREJECT
+        // Back to a saved point : periodic orbit, never escapes
+        if ((l == pl) & (m == pm)) k = MAX_ITERATIONS;
+        if (k == pk) {
+            pl = l;
+            pm = m;
+            pk <<= 1;
+        }
+#endif
+    }
+    return k;
+}
+#endif
+
+
+// -----------------------------------------------------------------------------------
+// Mandelbrot_fx parameters and tables
+// -----------------------------------------------------------------------------------
+// Shared by fixed point renderers (mandelbrot_fx, mandelbrot_ms)
+#ifndef FX_XMAX // reduced window, ex: zcc ... -DFX_XMAX=83 -DFX_YMAX=63
+#define FX_XMAX 335
+#define FX_YMAX 255
+#endif
+#define FX_MAX_ITERATIONS 45 
+#define FX_L_COLOR1 12
+#define FX_L_COLOR2 7
+#define FX_COLORG0 15
+#define FX_COLORG1 5
+#define FX_COLORG2 10
+#define FX_COLORG3 3
+#define FX_KCOLOR(k) ((k)==FX_MAX_ITERATIONS?FX_COLORG3:((k)>FX_L_COLOR1?FX_COLORG2:((k)>FX_L_COLOR2?FX_COLORG1:FX_COLORG0)))
+
+// Window in thousandths (same as a0, b0, c0, d0 of mandelbrot)
+#define FX_A0 (-1850) 
+#define FX_B0 (550) 
+#define FX_C0 (-1200) 
+#define FX_D0 (1200) 
+
+#define FX_TWO 8192 // 2.0
+#define FX_FOUR 16384 // 4.0
+
+int16_t mfx_ci[FX_XMAX + 1]; // real part of each column
+int16_t mfx_cj[FX_YMAX / 2 + 1]; // imaginary part of each row of lower half
+
+
+// -----------------------------------------------------------------------------------
+// Mandelbrot_fx_init
+// -----------------------------------------------------------------------------------
+// Compute coordinates of columns and rows in 4.12 (colors and mode are set by the renderers)
+// Coordinates are rounded to nearest : v * 4096 / 1000 = v * 512 / 125
+void mandelbrot_fx_init(void)
+{
+	static int32_t t;
+	static uint16_t x;
+	static uint8_t y;
+
+	for (x = 0; x <= FX_XMAX; x++) {
+		t = ((int32_t)FX_A0 * FX_XMAX + (int32_t)x * (FX_B0 - FX_A0)) * 512;
+		t = (t >= 0 ? t + 125L * FX_XMAX / 2 : t - 125L * FX_XMAX / 2) / (125L * FX_XMAX);
+		mfx_ci[x] = (int16_t)t;
+	}
+	for (y = 0; y <= FX_YMAX / 2; y++) {
+		t = ((int32_t)FX_C0 * FX_YMAX + (int32_t)y * (FX_D0 - FX_C0)) * 512;
+		t = (t >= 0 ? t + 125L * FX_YMAX / 2 : t - 125L * FX_YMAX / 2) / (125L * FX_YMAX);
+		mfx_cj[y] = (int16_t)t;
+	}
+}
+
+
+// -----------------------------------------------------------------------------------
+// Mandelbrot_fx_iter
+// -----------------------------------------------------------------------------------
+// Iterate the point of column x and row y (lower half) with 4.12 fixed point integers
+// Products are done by fx_mul2 and fx_sqr with a 32 bits intermediate result
+// As soon as |l| or |m| reaches 2, l*l + m*m is above 4 : the point escapes without
+// any further product, so all values stay in the 4.12 range (-8.0 to +8.0)
+// With MANDELBROT_FASTREJECT, points inside main cardioid or period 2 bulb are not iterated
+// and the loop stops when the orbit comes back to a saved point (Brent, saved at k = 1, 2, 4...),
+// same colors on the default window
+// Returns the number of iterations, FX_MAX_ITERATIONS for points of the set
+uint8_t mandelbrot_fx_iter(uint16_t x, uint8_t y)
+{
+	static int16_t i, j, l, m, n, o, p;
+	static uint8_t k;
+#ifdef MANDELBROT_FASTREJECT
+	static int16_t q, pl, pm;
+	static uint8_t pk;
+#endif
+
+	i = mfx_ci[x];
+	j = mfx_cj[y];
+#ifdef MANDELBROT_FASTREJECT
+	// Main cardioid : q * (q + x - 1/4) < y*y/4 with q = (x - 1/4)^2 + y^2
+	// tested only in -0.76 <= x <= 0.38 and |y| < 0.67 to stay in range of fx_mul
+	if ((i >= -3113) & (i <= 1556) & (j > -2744) & (j < 2744)) {
+		p = i - 1024;
+		o = fx_sqr(j);
+		q = fx_sqr(p) + o;
+		if (fx_mul(q, q + p) < (o >> 2)) return FX_MAX_ITERATIONS;
+	}
+	// Period 2 bulb : (x + 1)^2 + y^2 < 1/16, tested only in -1.25 <= x <= -0.75 and |y| < 0.25
+	if ((i >= -5120) & (i <= -3072) & (j > -1024) & (j < 1024)) {
+		if (fx_sqr(i + 4096) + fx_sqr(j) < 256) return FX_MAX_ITERATIONS;
+	}
+	pl = 0;
+	pm = 0;
+	pk = 1;
+#endif
+	k = 0;
+	l = 0;
+	m = 0;
+	n = 0;
+	o = 0;
+	while (k < FX_MAX_ITERATIONS) //Iterates
+	{
+		p = n - o + i;
+		m = fx_mul2(l, m) + j;
+		l = p;
+		k++;
+		if ((l >= FX_TWO) | (l <= -FX_TWO) | (m >= FX_TWO) | (m <= -FX_TWO)) break; // l*l + m*m >= 4
+		n = fx_sqr(l);
+		o = fx_sqr(m);
+		if ((n + o) >= FX_FOUR) break;
+#ifdef MANDELBROT_FASTREJECT
+		if ((l == pl) & (m == pm)) return FX_MAX_ITERATIONS; // periodic orbit, never escapes
+		if (k == pk) {
+			pl = l;
+			pm = m;
+			pk <<= 1;
+		}
+#endif
+	}
+	return k;
+}
+
+
+// -----------------------------------------------------------------------------------
+// Mandelbrot_fx_color
+// -----------------------------------------------------------------------------------
+// Returns the color of the point of column x and row y (lower half)
+uint8_t mandelbrot_fx_color(uint16_t x, uint8_t y)
+{
+	static uint8_t k;
+
+	k = mandelbrot_fx_iter(x, y);
+	return FX_KCOLOR(k);
+}
+
+
+// -----------------------------------------------------------------------------------
+// Mandelbrot_fx
+// -----------------------------------------------------------------------------------
+// Same figure as mandelbrot() computed with 4.12 fixed point integers (1.0 = 4096)
+// About 0.3% of the pixels (on the border of the set) get a different color than with double
+// Static variables are used essentially to avoid stack overflow
+// No math library required
+// With MANDELBROT_PROGRESSIVE, rendered by mandelbrot_progressive
+// Does not exit
+// On a DAI can exit with a long push on break
+void mandelbrot_fx(void)
+{
+	static uint8_t k;
+	static uint8_t lut[FX_MAX_ITERATIONS + 1]; // color of each number of iterations
+#ifndef MANDELBROT_PROGRESSIVE
+	static uint8_t line[FX_XMAX + 1]; // colors of current row
+	static uint16_t x;
+	static uint8_t y;
+#ifdef MANDELBROT_KCACHE
+	static uint8_t *kr;
+#endif
+#endif
+#ifdef MANDELBROT_CHECKPOINT
+	static int16_t win[4] = {FX_A0, FX_B0, FX_C0, FX_D0};
+#endif
+
+	dai_colorg(FX_COLORG0,FX_COLORG1,FX_COLORG2,FX_COLORG3); 
+	mandelbrot_fx_init();
+	for (k = 0; k <= FX_MAX_ITERATIONS; k++) lut[k] = FX_KCOLOR(k);
+#ifdef MANDELBROT_CHECKPOINT
+	k = mandelbrot_ckstart(2, 0x0A, FX_MAX_ITERATIONS, FX_XMAX, FX_YMAX, win);
+	if (k != 1) dai_mode (0x0A); // screen lost or new render
+#else
+	dai_mode (0x0A);
+#endif
+#ifdef MANDELBROT_KCACHE
+	mandelbrot_kinit(FX_XMAX, FX_YMAX, FX_MAX_ITERATIONS); // mode set : cache below its screen memory
+#ifdef MANDELBROT_CHECKPOINT
+	if (k == 2) {
+		if (mk_rows >= FX_YMAX / 2) mandelbrot_recolor(lut); // completed rows from the cache
+		else mandelbrot_ckstart(2, 0x0A, FX_MAX_ITERATIONS, FX_XMAX, FX_YMAX, win); // not all cached : new render
+	}
+#endif
+#endif
+
+#ifdef MANDELBROT_PROGRESSIVE
+	mandelbrot_progressive(mandelbrot_fx_iter, lut, FX_XMAX, FX_YMAX);
+#else
+#ifdef MANDELBROT_CHECKPOINT
+	y = ck_y ;
+#else
+	y = FX_YMAX / 2 ;
+#endif
+	do{
+#ifdef MANDELBROT_CHECKPOINT
+		mandelbrot_ckrow(0, y);
+#endif
+#ifdef MANDELBROT_KCACHE
+		kr = mandelbrot_krow(y);
+#endif
+		x = FX_XMAX;
+		do {
+			PROF_ENTER(PROF_ITER);
+			k = mandelbrot_fx_iter(x, y);
+			PROF_EXIT(PROF_ITER);
+#ifdef MANDELBROT_KCACHE
+			if (kr) kr[x] = k;
+#endif
+			line[x] = lut[k];
+			x-- ;
+		} while (x!=0) ;
+		PROF_ENTER(PROF_PLOT);
+		dai_dots(1, y, FX_XMAX, &line[1]);
+		dai_dots(1, (FX_YMAX - y), FX_XMAX, &line[1]);
+		PROF_EXIT(PROF_PLOT);
+		y--;
+	} while (y!=0) ;
+#endif
+#ifdef MANDELBROT_CHECKPOINT
+	mandelbrot_ckdone();
+#endif
+
+	// Draw a border
+	dai_vdraw(0,0, 0, FX_YMAX, FX_COLORG3) ;
+	dai_vdraw(0,FX_YMAX, FX_XMAX, FX_YMAX, FX_COLORG3) ;
+	dai_vdraw(FX_XMAX,0, FX_XMAX, FX_YMAX, FX_COLORG3) ;
+	dai_vdraw(FX_XMAX,0, 0, 0, FX_COLORG3) ;
+	
+#ifdef MANDELBROT_KCACHE
+	mandelbrot_recolor_demo();
+#endif
+	DEMO_END();
+}
+
+
+// -----------------------------------------------------------------------------------
+// Mandelbrot_ms
+// -----------------------------------------------------------------------------------
+// Same figure as mandelbrot_fx with rectangles subdivision (Mariani-Silver) :
+// - when all dots on the border of a rectangle have the same color, the inside is filled
+//   with dai_fill without computing it (the set and each color band are connected)
+// - otherwise the rectangle is split in two halves along its longer side, only the
+//   dividing line is computed and both halves are processed the same way
+// - small rectangles are computed dot by dot
+// Border dots are read back from the screen, so no dot is computed twice
+// On the default window about one dot out of four is computed
+// Differs from mandelbrot_fx only if a detail thinner than a dot crosses a rectangle
+// without touching its border (3 dots on the default window)
+// Rectangles are kept in a static stack (recursion not possible with a 128 bytes stack)
+// Only lower half is computed, dots and fills are mirrored on upper half
+// Does not exit
+// On a DAI can exit with a long push on break
+void mandelbrot_ms(void)
+{
+	#define MS_STACK 32 // rectangles waiting
+	#define MS_MIN 4 // rectangles smaller than this in both directions are computed dot by dot
+
+	static uint16_t sx0[MS_STACK], sx1[MS_STACK];
+	static uint8_t sy0[MS_STACK], sy1[MS_STACK];
+	static uint16_t x0, x1, x;
+	static uint8_t y0, y1, y, ns, color, same;
+
+	dai_colorg(FX_COLORG0,FX_COLORG1,FX_COLORG2,FX_COLORG3); 
+	dai_mode (0x0A);
+	mandelbrot_fx_init();
+
+	// Border of whole area : columns 1 to xmax, rows 1 to ymax/2
+	x0 = 1;
+	x1 = FX_XMAX;
+	y0 = 1;
+	y1 = FX_YMAX / 2;
+	for (x = x0; x <= x1; x++) {
+		mandelbrot_ms_dot(x, y0);
+		mandelbrot_ms_dot(x, y1);
+	}
+	for (y = y0 + 1; y < y1; y++) {
+		mandelbrot_ms_dot(x0, y);
+		mandelbrot_ms_dot(x1, y);
+	}
+	sx0[0] = x0; sy0[0] = y0; sx1[0] = x1; sy1[0] = y1;
+	ns = 1;
+
+	while (ns != 0) {
+		ns--;
+		x0 = sx0[ns]; y0 = sy0[ns]; x1 = sx1[ns]; y1 = sy1[ns];
+		if ((x1 - x0 < 2) | (y1 - y0 < 2)) continue; // nothing inside
+
+		// Same color all around ?
+		PROF_ENTER(PROF_BORDER);
+		color = dai_vscrn(x0, y0);
+		same = 1;
+		for (x = x0; (x <= x1) & same; x++) same = (dai_vscrn(x, y0) == color) & (dai_vscrn(x, y1) == color);
+		for (y = y0 + 1; (y < y1) & same; y++) same = (dai_vscrn(x0, y) == color) & (dai_vscrn(x1, y) == color);
+		PROF_EXIT(PROF_BORDER);
+		if (same) {
+			PROF_ENTER(PROF_FILL);
+			dai_vfill(x0 + 1, y0 + 1, x1 - 1, y1 - 1, color);
+			dai_vfill(x0 + 1, FX_YMAX - y1 + 1, x1 - 1, FX_YMAX - y0 - 1, color);
+			PROF_EXIT(PROF_FILL);
+			continue;
+		}
+
+		// Small rectangle or stack full : compute inside dot by dot
+		if (((x1 - x0 < MS_MIN) & (y1 - y0 < MS_MIN)) | (ns > MS_STACK - 2)) {
+			for (y = y0 + 1; y < y1; y++)
+				for (x = x0 + 1; x < x1; x++) mandelbrot_ms_dot(x, y);
+			continue;
+		}
+
+		// Split along the longer side, compute dividing line
+		if (x1 - x0 >= y1 - y0) {
+			x = (x0 + x1) / 2;
+			for (y = y0 + 1; y < y1; y++) mandelbrot_ms_dot(x, y);
+			sx0[ns] = x0; sy0[ns] = y0; sx1[ns] = x; sy1[ns] = y1;
+			ns++;
+			sx0[ns] = x; sy0[ns] = y0; sx1[ns] = x1; sy1[ns] = y1;
+			ns++;
+		}
+		else {
+			y = (y0 + y1) / 2;
+			for (x = x0 + 1; x < x1; x++) mandelbrot_ms_dot(x, y);
+			sx0[ns] = x0; sy0[ns] = y0; sx1[ns] = x1; sy1[ns] = y;
+			ns++;
+			sx0[ns] = x0; sy0[ns] = y; sx1[ns] = x1; sy1[ns] = y1;
+			ns++;
+		}
+	}
+
+	// Draw a border
+	dai_vdraw(0,0, 0, FX_YMAX, FX_COLORG3) ;
+	dai_vdraw(0,FX_YMAX, FX_XMAX, FX_YMAX, FX_COLORG3) ;
+	dai_vdraw(FX_XMAX,0, FX_XMAX, FX_YMAX, FX_COLORG3) ;
+	dai_vdraw(FX_XMAX,0, 0, 0, FX_COLORG3) ;
+	
+	DEMO_END();
+}
+
+
+// -----------------------------------------------------------------------------------
+// Mandelbrot_ms_dot
+// -----------------------------------------------------------------------------------
+// Compute dot x, y of lower half and plot it with its mirror in upper half
+void mandelbrot_ms_dot(uint16_t x, uint8_t y)
+{
+	static uint8_t color;
+
+	PROF_ENTER(PROF_ITER);
+	color = mandelbrot_fx_color(x, y);
+	PROF_EXIT(PROF_ITER);
+	PROF_ENTER(PROF_PLOT);
+	dai_vdot(x, y, color);
+	dai_vdot(x, FX_YMAX - y, color);
+	PROF_EXIT(PROF_PLOT);
+}
+
+
+// -----------------------------------------------------------------------------------
+// Mandelbrot_progressive
+// -----------------------------------------------------------------------------------
+// Coarse to fine rendering of the lower half of an image mirrored on its upper half
+// (columns 1 to cols, rows 1 to top/2, row y mirrored on row top - y)
+// Pass 1 computes dots whose x and y are multiples of 8 and fills a block of 8 x 8 dots
+// with each of them, passes 2, 3 and 4 do the same with 4, 2 and 1 : a preview of the whole
+// image is on the screen after 1/64 of the work
+// Dots already computed by a previous pass (x and y multiples of 2 * step) are not computed
+// again, so the total work is the same as a row by row scan
+// Blocks of the first column and row of each pass are extended to column and row 1
+// Input : iter = iterations of a dot (ex: mandelbrot_fx_iter), lut = color of each number
+// of iterations, cols and top = xmax and ymax of the image
+// Iterations are kept in the cache if MANDELBROT_KCACHE is defined
+// With MANDELBROT_CHECKPOINT, starts from step ck_step and row ck_y (see mandelbrot_ckstart)
+void mandelbrot_progressive(uint8_t (*iter)(uint16_t x, uint8_t y), uint8_t *lut, uint16_t cols, uint8_t top)
+{
+	static uint16_t x, x0, x1;
+	static uint8_t y, y0, y1, half, step, k, c;
+#ifdef MANDELBROT_KCACHE
+	static uint8_t *kr;
+#endif
+
+	half = top / 2;
+	step = 8;
+	y = 8;
+#ifdef MANDELBROT_CHECKPOINT
+	step = ck_step;
+	y = ck_y;
+#endif
+	for (; step != 0; step >>= 1, y = step) {
+		for (; y <= half; y += step) {
+#ifdef MANDELBROT_CHECKPOINT
+			mandelbrot_ckrow(step, y);
+#endif
+			y0 = (y == step ? 1 : y);
+			y1 = (y + step - 1 > half ? half : y + step - 1);
+#ifdef MANDELBROT_KCACHE
+			kr = mandelbrot_krow(y);
+#endif
+			for (x = step; x <= cols; x += step) {
+				if ((step != 8) & (((x | y) & step) == 0)) continue; // done by previous pass
+				PROF_ENTER(PROF_ITER);
+				k = iter(x, y);
+				PROF_EXIT(PROF_ITER);
+#ifdef MANDELBROT_KCACHE
+				if (kr) kr[x] = k;
+#endif
+				c = lut[k];
+				PROF_ENTER(PROF_PLOT);
+				if (step == 1) {
+					dai_vdot(x, y, c);
+					dai_vdot(x, top - y, c);
+				}
+				else {
+					x0 = (x == step ? 1 : x);
+					x1 = (x + step - 1 > cols ? cols : x + step - 1);
+					dai_vfill(x0, y0, x1, y1, c);
+					dai_vfill(x0, top - y1, x1, top - y0, c);
+				}
+				PROF_EXIT(PROF_PLOT);
+			}
+		}
+	}
+}
+
+
+#ifdef MANDELBROT_CHECKPOINT
+// -----------------------------------------------------------------------------------
+// Mandelbrot_ckarea
+// -----------------------------------------------------------------------------------
+// Check that CK_ADDR is above the program and its static variables (prog_end)
+// returns 1 if the block is at CK_ADDR, 0 if it overlaps the program : ck_area is then
+// moved to ck_ram so that the checkpoint writes do not overwrite the program
+uint8_t mandelbrot_ckarea(void)
+{
+	if (prog_end() <= CK_ADDR) return 1;
+	ck_area = ck_ram;
+	return 0;
+}
+
+
+// -----------------------------------------------------------------------------------
+// Mandelbrot_ckstart
+// -----------------------------------------------------------------------------------
+// Called by a renderer before it sets the graphic mode
+// Input : id = renderer (1 mandelbrot, 2 mandelbrot_fx), m = graphic mode, max = iterations of
+// the set, cols and top = xmax and ymax of the image, win = window in thousandths (4 values)
+// Sets ck_step and ck_y, the state to start from, and returns :
+// 0 : new render, the checkpoint block is written for it
+// 1 : resume (mandelbrot_resume) and the screen still holds the image : mode must not be set
+// 2 : resume, the screen is lost, the rows may be in the iterations cache : once the mode is
+// set and the cache sized (mandelbrot_kinit), the renderer redraws them if they all are,
+// or calls mandelbrot_ckstart again (new render)
+// When the screen is lost and there is no cache, the render starts again
+uint8_t mandelbrot_ckstart(uint8_t id, uint8_t m, uint8_t max, uint16_t cols, uint8_t top, int16_t *win)
+{
+	static uint8_t i, same;
+
+	if (!mandelbrot_ckarea()) ck_resume = 0;
+	same = ck_resume & (ck_area[0] == 'C') & (ck_area[1] == 'K') & (ck_area[2] == id) & (ck_area[3] == max)
+		& (CK_COLS == cols) & (ck_area[6] == top);
+	for (i = 0; i < 4; i++) same &= (CK_WIN[i] == win[i]);
+	ck_resume = 0;
+	if (same) {
+		ck_step = ck_area[7];
+		ck_y = ck_area[8];
+		dai_vinit(m); // rows table from the screen as it is
+		if (dai_vok & (dai_vxmax >= cols) & (dai_vymax >= top)) return 1;
+#ifdef MANDELBROT_KCACHE
+		if (ck_step == 0) return 2; // the renderer checks that all rows are cached
+#endif
+	}
+
+	ck_area[0] = 'C';
+	ck_area[1] = 'K';
+	ck_area[2] = id;
+	ck_area[3] = max;
+	CK_COLS = cols;
+	ck_area[6] = top;
+	for (i = 0; i < 4; i++) CK_WIN[i] = win[i];
+#ifdef MANDELBROT_PROGRESSIVE
+	ck_step = 8;
+	ck_y = 8;
+#else
+	ck_step = 0;
+	ck_y = top / 2;
+#endif
+	mandelbrot_ckrow(ck_step, ck_y);
+	return 0;
+}
+
+
+// -----------------------------------------------------------------------------------
+// Mandelbrot_ckrow
+// -----------------------------------------------------------------------------------
+// Save the next row to compute (called before each row)
+void mandelbrot_ckrow(uint8_t step, uint8_t y)
+{
+	ck_area[7] = step;
+	ck_area[8] = y;
+}
+
+
+// -----------------------------------------------------------------------------------
+// Mandelbrot_ckdone
+// -----------------------------------------------------------------------------------
+// Render finished : the next run starts a new one
+void mandelbrot_ckdone(void)
+{
+	ck_area[0] = 0;
+}
+
+
+// -----------------------------------------------------------------------------------
+// Mandelbrot_resume
+// -----------------------------------------------------------------------------------
+// Continue the render saved in the checkpoint block, from the row it was computing
+// Returns at once if there is no checkpoint (or one of a renderer not compiled),
+// does not exit otherwise
+void mandelbrot_resume(void)
+{
+	if (!mandelbrot_ckarea()) return; // the block would be in the program : nothing saved
+	if ((ck_area[0] != 'C') | (ck_area[1] != 'K')) return;
+	ck_resume = 1;
+#ifdef MANDELBROT_DOUBLE
+	if (ck_area[2] == 1) mandelbrot();
+#endif
+	if (ck_area[2] == 2) mandelbrot_fx();
+	ck_resume = 0;
+}
+#endif
+
+
+#ifdef MANDELBROT_KCACHE
+// -----------------------------------------------------------------------------------
+// Mandelbrot_kinit
+// -----------------------------------------------------------------------------------
+// Start a new image in the iteration counts cache, called once the graphic mode is set :
+// the rows cached stop below the screen memory of the mode (dai_vlow), none if it is
+// lower than MK_ADDR
+// Input : cols = columns 1 to cols, top = ymax of the image, max = iterations of the set
+void mandelbrot_kinit(uint16_t cols, uint8_t top, uint8_t max)
+{
+	static uint16_t size;
+
+	mk_xmax = cols;
+	mk_ymax = top;
+	mk_max = max;
+	mk_rows = top / 2;
+	size = MK_SIZE;
+	if (dai_vlow <= mk_buf) size = 0;
+	else if (dai_vlow - mk_buf < size) size = dai_vlow - mk_buf;
+	if (size / cols < mk_rows) mk_rows = size / cols;
+}
+
+
+// -----------------------------------------------------------------------------------
+// Mandelbrot_krow
+// -----------------------------------------------------------------------------------
+// Returns a pointer p with p[x] = iterations of column x of row y, 0 if the row is not cached
+uint8_t *mandelbrot_krow(uint8_t y)
+{
+	if ((y == 0) | (y > mk_rows)) return 0;
+	return mk_buf + (y - 1) * mk_xmax - 1;
+}
+
+
+// -----------------------------------------------------------------------------------
+// Mandelbrot_recolor
+// -----------------------------------------------------------------------------------
+// Plot again the cached rows and their mirrors without computing them
+// Column mk_xmax is left as it is : the renderers draw their right border on it
+// Input : lut = color of each number of iterations, 0 to mk_max
+void mandelbrot_recolor(uint8_t *lut)
+{
+	static uint8_t line[336]; // colors of current row, widest graphic mode
+	static uint16_t x;
+	static uint8_t y;
+	static uint8_t *kr;
+
+	for (y = 1; y <= mk_rows; y++) {
+		kr = mandelbrot_krow(y);
+		for (x = 1; x < mk_xmax; x++) line[x] = lut[kr[x]];
+		dai_dots(1, y, mk_xmax - 1, &line[1]);
+		dai_dots(1, mk_ymax - y, mk_xmax - 1, &line[1]);
+	}
+}
+
+
+// -----------------------------------------------------------------------------------
+// Mandelbrot_recolor_demo
+// -----------------------------------------------------------------------------------
+// Recolor the cached image with moving thresholds of the color bands
+// Colors of the palette set by dai_colorg, band 1 above t iterations, band 2 above 2 * t
+// A key moves to the next thresholds
+// Does not exit, returns at once in the host build (the screen keeps the render)
+void mandelbrot_recolor_demo(void)
+{
+	static uint8_t lut[256];
+	static uint8_t t, k;
+
+#ifdef DAI_HOST
+	return;
+#endif
+	while (1) {
+		for (t = 2; t < 20; t += 3) {
+			k = 0;
+			do lut[k] = dai_palette[(k == mk_max ? 3 : (k > 2 * t ? 2 : (k > t ? 1 : 0)))];
+			while (k++ != mk_max);
+			mandelbrot_recolor(lut);
+			DEMO_KEY(); // next thresholds on a key
+		}
+	}
+}
+#endif
+
+
+//====================================================================================
+// ESCAPE TIME ENGINE
+//====================================================================================
+// Renders any window of a fractal in any graphic mode with colors given at run time.
+// The kernel and the numbers are chosen at compile time (ET_KERNEL, ET_NUMBER) : each
+// build has one inner loop without any test of the variant for each dot.
+// Window : x min, x max, y min, y max in thousandths, then for Julia the real and
+// imaginary parts of the constant (thousandths), y min at the bottom of the screen.
+// Numbers :
+// - ET_FX412 : 4.12 fixed point (fx_mul, fx_mul2, fx_sqr), windows within -8.0 to +8.0
+// - ET_FX88 : 8.8 fixed point on the same multiplication (operand shifted by 4), coarser
+//   but same speed, for large windows or to see the effect of precision
+// - ET_MBF32 : floating point, needs MANDELBROT_DOUBLE and --math-mbf32
+// With fixed point numbers a dot escapes as soon as |re| or |im| reaches 2, so all values
+// stay in range (see mandelbrot_fx_iter)
+#define ET_MANDELBROT 0 // z = z^2 + c, z0 = 0, c = dot
+#define ET_JULIA 1 // z = z^2 + c, z0 = dot, c = constant of the window
+#define ET_BURNINGSHIP 2 // z = (|re z| + i |im z|)^2 + c, z0 = 0, c = dot
+#define ET_FX412 0
+#define ET_FX88 1
+#define ET_MBF32 2
+
+#ifndef ET_KERNEL
+#define ET_KERNEL ET_MANDELBROT
+#endif
+#ifndef ET_NUMBER
+#define ET_NUMBER ET_FX412
+#endif
+
+#if ET_NUMBER == ET_MBF32
+#ifndef MANDELBROT_DOUBLE
+#error "ET_MBF32 requires MANDELBROT_DOUBLE"
+#endif
+typedef double et_t;
+#define ET_MILLI(v) ((double)(v) / 1000.0)
+#define ET_SQR(a) ((a) * (a))
+#define ET_MUL2(a, b) (2.0 * (a) * (b))
+#define ET_OUT(a) 0
+#define ET_FOUR 4.0
+#elif ET_NUMBER == ET_FX88
+typedef int16_t et_t;
+#define ET_ONE 256
+#define ET_SCALE 32 // ET_ONE / 1000 = 32 / 125
+#define ET_SQR(a) fx_mul((a) * 16, (a))
+#define ET_MUL2(a, b) fx_mul2((a) * 16, (b))
+#else
+typedef int16_t et_t;
+#define ET_ONE 4096
+#define ET_SCALE 512 // ET_ONE / 1000 = 512 / 125
+#define ET_SQR(a) fx_sqr(a)
+#define ET_MUL2(a, b) fx_mul2((a), (b))
+#endif
+#if ET_NUMBER != ET_MBF32
+#define ET_OUT(a) (((a) >= 2 * ET_ONE) | ((a) <= -2 * ET_ONE)) // |a| >= 2.0
+#define ET_FOUR (4 * ET_ONE)
+#endif
+#define ET_ABS(a) ((a) < 0 ? -(a) : (a))
+
+et_t et_cx[336]; // real part of each column
+et_t et_cy[256]; // imaginary part of each row
+#if ET_KERNEL == ET_JULIA
+et_t et_jr, et_ji; // constant of Julia
+#endif
+uint8_t et_max; // iterations of points of the set
+
+
+// -----------------------------------------------------------------------------------
+// et_render
+// -----------------------------------------------------------------------------------
+// Set colors and mode m, then render window win row by row from the bottom
+// Input : win (see above), m as dai_mode, colors = 4 colors as dai_colorg, max = iterations
+// of points of the set (at most 255), dots escaping after more than t2 iterations take
+// colors[2], more than t1 colors[1], others colors[0], points of the set colors[3]
+// Mandelbrot windows symmetric around the real axis are computed for the lower half only
+void et_render(int16_t *win, uint8_t m, uint8_t *colors, uint8_t max, uint8_t t1, uint8_t t2)
+{
+	static uint8_t line[336]; // colors of current row
+	static uint8_t lut[256]; // color of each number of iterations
+	static uint16_t x, cols;
+	static uint8_t y, top, k, mirror;
+
+	dai_colorg(colors[0], colors[1], colors[2], colors[3]);
+	dai_mode(m);
+	cols = dai_xmax();
+	top = dai_ymax();
+	if ((cols > 335) | (m == 0xFF)) return;
+	et_init(win, cols, top);
+	et_max = max;
+	k = 0;
+	do lut[k] = colors[(k == max ? 3 : (k > t2 ? 2 : (k > t1 ? 1 : 0)))];
+	while (k++ != max);
+	mirror = ((ET_KERNEL == ET_MANDELBROT) & (win[2] == -win[3]));
+	for (y = 0; ; y++) {
+		for (x = 0; x <= cols; x++) line[x] = lut[et_iter(x, y)];
+		dai_dots(0, y, cols + 1, line);
+		if (mirror) dai_dots(0, top - y, cols + 1, line);
+		if (y == (mirror ? top / 2 : top)) break;
+	}
+}
+
+
+// -----------------------------------------------------------------------------------
+// et_init
+// -----------------------------------------------------------------------------------
+// Coordinates of columns 0 to cols and rows 0 to top of window win, rounded to nearest
+// for fixed point numbers (v * ET_ONE / 1000 = v * ET_SCALE / 125, as mandelbrot_fx_init)
+void et_init(int16_t *win, uint16_t cols, uint8_t top)
+{
+	static uint16_t x;
+	static uint8_t y;
+#if ET_NUMBER != ET_MBF32
+	static int32_t t;
+
+	for (x = 0; x <= cols; x++) {
+		t = ((int32_t)win[0] * cols + (int32_t)x * (win[1] - win[0])) * ET_SCALE;
+		t = (t >= 0 ? t + 125L * cols / 2 : t - 125L * cols / 2) / (125L * cols);
+		et_cx[x] = (int16_t)t;
+	}
+	for (y = 0; ; y++) { // y <= top would not end for top = 255
+		t = ((int32_t)win[2] * top + (int32_t)y * (win[3] - win[2])) * ET_SCALE;
+		t = (t >= 0 ? t + 125L * top / 2 : t - 125L * top / 2) / (125L * top);
+		et_cy[y] = (int16_t)t;
+		if (y == top) break;
+	}
+#if ET_KERNEL == ET_JULIA
+	et_jr = (int16_t)(((int32_t)win[4] * ET_SCALE + (win[4] >= 0 ? 62 : -62)) / 125);
+	et_ji = (int16_t)(((int32_t)win[5] * ET_SCALE + (win[5] >= 0 ? 62 : -62)) / 125);
+#endif
+#else
+	for (x = 0; x <= cols; x++) et_cx[x] = ET_MILLI(win[0]) + (double)x * ET_MILLI(win[1] - win[0]) / (double)cols;
+	for (y = 0; ; y++) {
+		et_cy[y] = ET_MILLI(win[2]) + (double)y * ET_MILLI(win[3] - win[2]) / (double)top;
+		if (y == top) break;
+	}
+#if ET_KERNEL == ET_JULIA
+	et_jr = ET_MILLI(win[4]);
+	et_ji = ET_MILLI(win[5]);
+#endif
+#endif
+}
+
+
+// -----------------------------------------------------------------------------------
+// et_iter
+// -----------------------------------------------------------------------------------
+// Iterate the dot of column x and row y with the kernel and numbers of the build
+// Returns the number of iterations before escape (|z| >= 2), et_max for points of the set
+uint8_t et_iter(uint16_t x, uint8_t y)
+{
+	static et_t i, j, l, m, n, o;
+	static uint8_t k;
+
+#if ET_KERNEL == ET_JULIA
+	l = et_cx[x];
+	m = et_cy[y];
+	i = et_jr;
+	j = et_ji;
+#else
+	l = 0;
+	m = 0;
+	i = et_cx[x];
+	j = et_cy[y];
+#endif
+	k = 0;
+	while (1) {
+		if (ET_OUT(l) | ET_OUT(m)) break;
+		n = ET_SQR(l);
+		o = ET_SQR(m);
+		if ((n + o) >= ET_FOUR) break;
+		if (k == et_max) break;
+#if ET_KERNEL == ET_BURNINGSHIP
+		m = ET_MUL2(ET_ABS(l), ET_ABS(m)) + j;
+#else
+		m = ET_MUL2(l, m) + j;
+#endif
+		l = n - o + i;
+		k++;
+	}
+	return k;
+}
+
+
+// -----------------------------------------------------------------------------------
+// test_escape
+// -----------------------------------------------------------------------------------
+// Windows of the kernel of the build in several modes, a key shows the next one
+// Does not exit
+// On a DAI can exit with a long push on break
+void test_escape(void)
+{
+#if ET_KERNEL == ET_JULIA
+	static int16_t win[3][6] = {{-1600, 1600, -1200, 1200, -800, 156}, {-1500, 1500, -1000, 1000, 285, 10}, {-400, 400, -300, 300, -800, 156}};
+#elif ET_KERNEL == ET_BURNINGSHIP
+	static int16_t win[3][6] = {{-2200, 1300, -1800, 700}, {-1800, -1700, -80, 20}, {-1780, -1740, -50, -20}};
+#else
+	static int16_t win[3][6] = {{-1850, 550, -1200, 1200}, {-900, -600, 0, 250}, {-780, -720, 80, 130}};
+#endif
+	static uint8_t colors[3][4] = {{15, 5, 10, 3}, {0, 1, 9, 15}, {0, 3, 14, 15}};
+	static uint8_t modes[3] = {0x0A, 0x06, 0x08};
+	static uint8_t n;
+
+	for (n = 0; n < 3; n++) {
+		et_render(win[n], modes[n], colors[n], (n == 0 ? 45 : 90), (n == 0 ? 7 : 15), (n == 0 ? 12 : 30));
+		DEMO_KEY(); // next window on a key
+	}
+	DEMO_END();
 }
 
 
@@ -161,16 +1277,136 @@ void test_graphics(void)
 	dai_draw(0,0, dai_xmax(), dai_ymax(), 10) ; // Orange cross 1st line
 	dai_draw(0,dai_ymax(), dai_xmax(),0 , 10) ; // Orange cross 2nd line
 	dai_dot(dai_xmax()/2, dai_ymax()/2, 5); // Green dot in the middle
-	for (uint16_t i=0;i<60000;i++){}  // Wait
 	c = dai_scrn(10,40);
-	printf("Background 15 color %d \n",c) ;
-	for (uint16_t i=0;i<60000;i++){}  // Wait
+	dai_puts("Background 15 color ") ;
+	dai_print_uint(c) ;
+	dai_puts(" \n") ;
 	c = dai_scrn(dai_xmax()/2, dai_ymax()/2) ; // get color of center
-	printf("center 5 color %d \n",c) ;
-	for (uint16_t i=0;i<60000;i++){}  // Wait
+	dai_puts("center 5 color ") ;
+	dai_print_uint(c) ;
+	dai_puts(" \n") ;
 	c = dai_scrn(dai_xmax()/2, 0) ; // get color of rectangle
-	printf("rectangle 3 color %d \n",c) ;
-	while(1);
+	dai_puts("rectangle 3 color ") ;
+	dai_print_uint(c) ;
+	dai_puts(" \n") ;
+	DEMO_END();
+}
+
+
+// -----------------------------------------------------------------------------------
+// test_shapes
+// -----------------------------------------------------------------------------------
+// Two gauges (filled circle, arcs of octants, needle) and a chart of filled ellipses
+// Does not exit
+// On a DAI can exit with a long push on break
+void test_shapes(void)
+{
+	static uint8_t n;
+
+	dai_colorg(15,5,10,3); // white background, green, orange, red
+	dai_mode(0x0B); // Mode 6
+	dai_vclear(15);
+
+	// Gauges : dial, green and orange then red octants of the upper half, needle
+	for (n = 0; n < 2; n++) {
+		dai_circlefill(80 + 176 * n, 170, 60, 5);
+		dai_circlefill(80 + 176 * n, 170, 52, 15);
+		dai_arc(80 + 176 * n, 170, 48, 0x0C, 5);
+		dai_arc(80 + 176 * n, 170, 48, 0x02, 10);
+		dai_arc(80 + 176 * n, 170, 48, 0x01, 3);
+		dai_arc(80 + 176 * n, 170, 47, 0x01, 3);
+		dai_circle(80 + 176 * n, 170, 4, 3);
+		dai_vdraw(80 + 176 * n, 170, (n == 0 ? 50 : 291), 205, 3); // needles at 130 and 45 degrees
+	}
+
+	// Chart : bubbles of several sizes, outlined, then a flat ellipse as shadow
+	dai_ellipsefill(168, 20, 150, 6, 10);
+	for (n = 0; n < 5; n++) {
+		dai_ellipsefill(40 + 64 * n, 40 + 8 * n, 12 + 4 * n, 8 + 3 * n, (n & 1 ? 10 : 5));
+		dai_ellipse(40 + 64 * n, 40 + 8 * n, 12 + 4 * n, 8 + 3 * n, 3);
+	}
+	DEMO_END();
+}
+
+
+// -----------------------------------------------------------------------------------
+// test_fills
+// -----------------------------------------------------------------------------------
+// A star and a concave arrow filled with dai_fill_polygon, then areas between circles
+// and lines filled with dai_flood_fill (seeds in a static buffer, not on the stack)
+// Does not exit
+// On a DAI can exit with a long push on break
+void test_fills(void)
+{
+	static uint16_t star_x[10] = {80, 92, 128, 98, 110, 80, 50, 62, 32, 68};
+	static uint8_t star_y[10] = {240, 206, 204, 182, 146, 168, 146, 182, 204, 206};
+	static uint16_t arrow_x[7] = {170, 250, 250, 310, 250, 250, 170};
+	static uint8_t arrow_y[7] = {180, 180, 150, 195, 240, 210, 210};
+	static uint8_t seeds[300]; // 100 seeds
+	static uint8_t ok;
+
+	dai_colorg(15,5,10,3); // white background, green, orange, red
+	dai_mode(0x0B); // Mode 6
+	dai_vclear(15);
+	dai_fill_polygon(10, star_x, star_y, 10);
+	dai_fill_polygon(7, arrow_x, arrow_y, 5);
+
+	// Rings and a bar cut the area in pieces, each one filled from a dot inside
+	dai_circle(90, 70, 60, 3);
+	dai_circle(90, 70, 30, 3);
+	dai_vdraw(0, 70, 180, 70, 3);
+	dai_ellipse(260, 70, 70, 50, 3);
+	dai_vfill(250, 10, 270, 130, 3);
+	ok = dai_flood_fill(90, 120, 10, seeds, sizeof(seeds)); // upper half of the ring
+	ok &= dai_flood_fill(90, 20, 5, seeds, sizeof(seeds)); // lower half
+	ok &= dai_flood_fill(90, 80, 3, seeds, sizeof(seeds)); // upper half of the center
+	ok &= dai_flood_fill(220, 70, 10, seeds, sizeof(seeds)); // left of the bar
+	ok &= dai_flood_fill(300, 70, 5, seeds, sizeof(seeds)); // right of the bar
+	dai_puts(ok ? "Fills done \n" : "Fills stack full \n");
+	DEMO_END();
+}
+
+
+// -----------------------------------------------------------------------------------
+// test_sprites
+// -----------------------------------------------------------------------------------
+// A ball (transparent corners) bouncing over stripes : at each step dai_unblit puts the
+// stripes back under the old place, then dai_blit draws the ball at the new one
+// Does not exit
+// On a DAI can exit with a long push on break
+void test_sprites(void)
+{
+	static uint8_t ball[16 * 16]; // colors of the dots, row by row from the top
+	static uint8_t spr[DAI_SPRSIZE(16, 16)];
+	static uint8_t save[DAI_SAVESIZE(16, 16)];
+	static uint16_t x;
+	static int16_t d;
+	static uint8_t y, i, j;
+	static int8_t dy;
+
+	dai_colorg(15,5,10,3); // white background, green, orange, red
+	dai_mode(0x0B); // Mode 6
+	dai_vclear(15);
+	for (i = 0; i < 8; i++) dai_vfill(i * 42, 0, i * 42 + 20, dai_ymax(), 5);
+	for (j = 0; j < 16; j++) {
+		for (i = 0; i < 16; i++) {
+			d = (2 * i - 15) * (2 * i - 15) + (2 * j - 15) * (2 * j - 15); // 4 * square of distance to the center
+			ball[j * 16 + i] = (d > 225 ? 0xFF : (d < 60 ? 10 : 3));
+		}
+	}
+	dai_sprmake(spr, 16, 16, ball);
+	x = 0;
+	y = 200;
+	dy = -3;
+	dai_blit(spr, x, y, save);
+	while (x < 318) {
+		dai_unblit(spr, x, y, save);
+		x++;
+		y += dy;
+		if ((y < 40) | (y > 230)) dy = -dy;
+		dai_blit(spr, x, y, save);
+	}
+	DEMO_END();
 }
 
 
@@ -190,255 +1426,156 @@ void test_texts(void)
 	dai_clearscreen(); // clear text screen by sending char 0x0C
 	px1 = dai_curx() ;
 	py1 = dai_cury() ;
-	printf("Pos 1 %d,%d\n",px1,py1) ; // Print current position of cursor (orange on black background)
-	for (uint16_t i=0;i<60000;i++){}  // Wait
+	dai_puts("Pos 1 ") ; // Print current position of cursor (orange on black background)
+	dai_print_uint(px1) ;
+	dai_puts(",") ;
+	dai_print_uint(py1) ;
+	dai_puts("\n") ;
 	dai_cursor(px2,py2) ;
-	printf("Pos 18,7 %d,%d\n",px2,py2) ; // Print new position of cursor
+	dai_puts("Pos 18,7 ") ; // Print new position of cursor
+	dai_print_uint(px2) ;
+	dai_puts(",") ;
+	dai_print_uint(py2) ;
+	dai_puts("\n") ;
 
-	while(1);
+	DEMO_END();
 }
 
 
-//====================================================================================
-// LIBRARY EMULATING FUNCTIONS
-//====================================================================================
-// "__asm__" 8080 mnemonics are in Z80 style due to z88 compiler requirements
-// No purely Z80 mnemonic is used
-
-
-// -----------------------------------------------------------------------------------
-// dai_mode : Change graphic modes
 // -----------------------------------------------------------------------------------
-// Graphic mode (*A = graphic area with 4 text lines of 60 characters)
-// Input :  
-// 0xFF = text, 24 lines, 60 characters
-// 0  = mode 1, 1  = mode 1A, 72x65, 16 colors
-// 2  = mode 2, 3  = mode 2A, 72x65, 4 colors
-// 4  = mode 3, 5  = mode 3A, 160x130, 16 colors
-// 6  = mode 4, 7  = mode 4A, 160x130, 4 colors
-// 8  = mode 5, 9  = mode 5A, 336x256, 16 colors
-// 10 = mode 6, 11 = mode 6A, 336x256, 4 colors
-// Registers are saved
-// Uses Dai ROM related function
+// test_tasks
 // -----------------------------------------------------------------------------------
-void dai_mode(uint8_t m) {
-	__asm__(" push af");
-	__asm__(" push hl");
-	__asm__(" ld hl,$0006");	
-	__asm__(" add hl,sp"); 
-	__asm__(" ld a,(hl)");
-	__asm__(" rst 5");
-	__asm__(" defb $18"); // call $E3D9 in ROM
-	__asm__(" pop hl");
-	__asm__(" pop af");
+// Mandelbrot_fx in mode 6A computed by a task which yields after each row, while a second
+// task shows the current row in the text lines and pauses or continues on space bar
+// Does not exit
+// On a DAI can exit with a long push on break
+void test_tasks(void)
+{
+	dai_colorg(FX_COLORG0,FX_COLORG1,FX_COLORG2,FX_COLORG3); 
+	dai_mode(0x0B); // Mode 6A
+	mandelbrot_fx_init();
+	task_add(mandelbrot_fx_task);
+	task_add(status_task);
+	task_run(); // status_task does not end
 }
 
 
 // -----------------------------------------------------------------------------------
-// dai_colorg 
+// mandelbrot_fx_task
 // -----------------------------------------------------------------------------------
-// Change graphic colors (equivalent of colorg)
-// Input : color 0,1,2,3 (from 0 to 15)
-// Registers are saved
-// Uses Dai ROM related function
-// -----------------------------------------------------------------------------------
-void dai_colorg(uint8_t C0,uint8_t C1,uint8_t C2,uint8_t C3) {
-	__asm__(" push af");
-	__asm__(" push hl");
-	__asm__(" push de");
-	__asm__(" ld hl,$0008");	
-	__asm__(" add hl,sp"); 
-	__asm__(" ld de,$011C");
-	__asm__(" ld a,(hl)"); // C3, Color 0-15
-	__asm__(" ld (de),a"); 
-	__asm__(" dec de");
-	__asm__(" inc hl");
-	__asm__(" inc hl");
-	__asm__(" ld a,(hl)"); // C2, Color 0-15
-	__asm__(" ld (de),a");
-	__asm__(" dec de");
-	__asm__(" inc hl");
-	__asm__(" inc hl");
-	__asm__(" ld a,(hl)"); // C1, Color 0-15
-	__asm__(" ld (de),a");
-	__asm__(" dec de");
-	__asm__(" inc hl");
-	__asm__(" inc hl");
-	__asm__(" ld a,(hl)"); // C0, Color 0-15
-	__asm__(" ld (de),a");
-	__asm__(" ld hl,$0119");
-	__asm__(" rst 5");
-	__asm__(" defb $1B"); // call $E6A4 in ROM, input color vectors (coding 0-15) pointer in hl
-	__asm__(" pop de");
-	__asm__(" pop hl");
-	__asm__(" pop af");
+// Same rendering as mandelbrot_fx (mode and tables set by the caller), one row per call,
+// waits while task_pause is set
+uint8_t mandelbrot_fx_task(uint16_t *pt)
+{
+	static uint8_t line[FX_XMAX + 1]; // colors of current row
+	static uint16_t x;
+
+	PT_BEGIN(pt);
+	for (task_row = FX_YMAX / 2; task_row != 0; task_row--) {
+		for (x = FX_XMAX; x != 0; x--) line[x] = mandelbrot_fx_color(x, task_row);
+		dai_dots(1, task_row, FX_XMAX, &line[1]);
+		dai_dots(1, FX_YMAX - task_row, FX_XMAX, &line[1]);
+		PT_YIELD(pt);
+		PT_WAIT_UNTIL(pt, task_pause == 0);
+	}
+
+	// Draw a border
+	dai_vdraw(0,0, 0, FX_YMAX, FX_COLORG3) ;
+	dai_vdraw(0,FX_YMAX, FX_XMAX, FX_YMAX, FX_COLORG3) ;
+	dai_vdraw(FX_XMAX,0, FX_XMAX, FX_YMAX, FX_COLORG3) ;
+	dai_vdraw(FX_XMAX,0, 0, 0, FX_COLORG3) ;
+	PT_END(pt);
 }
 
 
 // -----------------------------------------------------------------------------------
-// dai_dot 
-// -----------------------------------------------------------------------------------
-// Draw a dot using color reference set by Colorg
-// Default avaialble colors on reset are 0, 5, 10, 15
-// Input : x, y, color
-// Registers are saved
-// Uses Dai ROM related function
+// status_task
 // -----------------------------------------------------------------------------------
-void dai_dot(uint16_t x, uint8_t y, uint8_t c){
-	__asm__(" push af");
-	__asm__(" push hl");
-	__asm__(" push bc");
-	__asm__(" ld hl,$0008");	
-	__asm__(" add hl,sp"); 
-	__asm__(" ld a, (hl)"); // color in a
-	__asm__(" inc hl");
-	__asm__(" inc hl");
-	__asm__(" ld c,(hl)"); // y in c
-	__asm__(" inc hl");
-	__asm__(" inc hl");
-	__asm__(" ld b,(hl)"); // x in hl
-	__asm__(" inc hl");
-	__asm__(" ld h,(hl)");
-	__asm__(" ld l, b");		
-	// Input for Dai functions: x = HL, y = C, A : Color
-	__asm__(" rst 5");
-	__asm__(" defb $1E"); // call $E710 in ROM, input color vectors (coding 0-15) pointer in hl
-	__asm__(" pop bc");
-	__asm__(" pop hl");
-	__asm__(" pop af");
+// Polls the keyboard (space bar : pause / continue) and prints the row of
+// mandelbrot_fx_task on the current text line when it changes
+// Never ends
+uint8_t status_task(uint16_t *pt)
+{
+	static uint8_t cy, shown, paused;
+
+	PT_BEGIN(pt);
+	cy = dai_cury();
+	shown = 0xFF;
+	paused = 0xFF;
+	while (1) {
+		if (getk() == ' ') task_pause ^= 1;
+		if ((task_row != shown) | (task_pause != paused)) {
+			shown = task_row;
+			paused = task_pause;
+			dai_cursor(0, cy);
+			if (shown == 0) dai_puts("Done                ");
+			else {
+				dai_puts("Row ");
+				dai_print_uint(shown);
+				dai_puts(paused ? " paused  " : "         ");
+			}
+		}
+		PT_YIELD(pt);
+	}
+	PT_END(pt);
 }
 
 
-// -----------------------------------------------------------------------------------
-// dai_draw 
-// -----------------------------------------------------------------------------------
-// Draw a dot using color reference set by Colorg
-// Input : x0, y0, x1, y1, color
-// Registers are saved
-// Uses Dai ROM related function
-// -----------------------------------------------------------------------------------
-void dai_draw(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint8_t c) {
-	__asm__(" push af");
-	__asm__(" push hl");
-	__asm__(" push bc");	
-	__asm__(" push de");	
-	__asm__(" ld hl,$000A");	
-	__asm__(" add hl,sp"); 
-	__asm__(" ld a, (hl)"); // color in a
-	__asm__(" inc hl");
-	__asm__(" inc hl");
-	__asm__(" ld b,(hl)"); // y1 in b
-	__asm__(" inc hl");
-	__asm__(" inc hl");
-	__asm__(" ld e,(hl)"); // x1 in de
-	__asm__(" inc hl");
-	__asm__(" ld d,(hl)"); 
-	__asm__(" inc hl");
-	__asm__(" ld c,(hl)"); // y0 in c
-	__asm__(" push bc");
-	__asm__(" inc hl");
-	__asm__(" inc hl");
-	__asm__(" ld b,(hl)"); // x0 in hl via b
-	__asm__(" inc hl");
-	__asm__(" ld h,(hl)");
-	__asm__(" ld l, b");		
-	__asm__(" pop bc");
-	// Input for Dai functions: x0 = HL, x1 = DE, y0 = C, y1 = B, A = Color
-	__asm__(" rst 5");
-	__asm__(" defb $21");
-	__asm__(" pop de");	
-	__asm__(" pop bc");
-	__asm__(" pop hl");
-	__asm__(" pop af");
-}
 
 
+//====================================================================================
+// FIXED POINT ARITHMETIC
+//====================================================================================
+// 4.12 signed format : 1.0 = 4096, range -8.0 to +8.0
+// Products are computed on 32 bits then rounded to 4.12
+
+#ifdef DAI_HOST
 // -----------------------------------------------------------------------------------
-// dai_fill 
-// -----------------------------------------------------------------------------------
-// Draw a rectangle using color reference set by Colorg
-// Input : x0, y0, x1, y1, color
-// Registers are saved
-// Uses Dai ROM related function
+// Host build : same results as fx_mulcore (products of absolute values, rounded to
+// nearest, then signed)
 // -----------------------------------------------------------------------------------
-void dai_fill(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint8_t c) {
-	__asm__(" push af");
-	__asm__(" push hl");
-	__asm__(" push bc");	
-	__asm__(" push de");	
-	__asm__(" ld hl,$000A");	
-	__asm__(" add hl,sp"); 
-	__asm__(" ld a, (hl)"); // color in a
-	__asm__(" inc hl");
-	__asm__(" inc hl");
-	__asm__(" ld b,(hl)"); // y1 in b
-	__asm__(" inc hl");
-	__asm__(" inc hl");
-	__asm__(" ld e,(hl)"); // x1 in de
-	__asm__(" inc hl");
-	__asm__(" ld d,(hl)"); 
-	__asm__(" inc hl");
-	__asm__(" ld c,(hl)"); // y0 in c
-	__asm__(" push bc");
-	__asm__(" inc hl");
-	__asm__(" inc hl");
-	__asm__(" ld b,(hl)"); // x0 in hl via b
-	__asm__(" inc hl");
-	__asm__(" ld h,(hl)");
-	__asm__(" ld l, b");		
-	__asm__(" pop bc");
-	// Input for Dai functions: x0 = HL, x1 = DE, y0 = C, y1 = B, A = Color
-	__asm__(" rst 5");
-	__asm__(" defb $24"); // call $E818 in ROM, input color vectors (coding 0-15) pointer in hl
-	__asm__(" pop de");	
-	__asm__(" pop bc");
-	__asm__(" pop hl");
-	__asm__(" pop af");
+int16_t fx_mul(int16_t a, int16_t b)
+{
+	int32_t p = (int32_t)(a < 0 ? -a : a) * (b < 0 ? -b : b);
+
+	p = (p + 2048) >> 12;
+	return (int16_t)(((a < 0) != (b < 0)) ? -p : p);
 }
 
+int16_t fx_mul2(int16_t a, int16_t b)
+{
+	return fx_mul(a, 2 * b);
+}
 
-// -----------------------------------------------------------------------------------
-// dai_xmax 
-// -----------------------------------------------------------------------------------
-// get xmax of a graphic screen. 0,0 bottom left
-// Registers are saved except hl used for result
-// Uses Dai ROM related function
-// return in hl
-uint16_t dai_xmax(void)
+int16_t fx_sqr(int16_t a)
 {
-	__asm__(" push af");
-	__asm__(" push bc");
-	__asm__(" push de");
-	__asm__(" ld hl,$0000"); // x in hl
-	__asm__(" ld c,$00"); // y in c
-	__asm__(" rst 5");
-	__asm__(" defb $27"); // call $E884 in ROM, return a=color, b=ymax, de=xmax
-	__asm__(" ld h,d"); // xmax in hl
-	__asm__(" ld l,e"); 
-	__asm__(" pop de");
-	__asm__(" pop bc");
-	__asm__(" pop af");
+	return fx_mul(a, a);
 }
+#else
 
 
 // -----------------------------------------------------------------------------------
-// dai_ymax 
+// fx_mul 
 // -----------------------------------------------------------------------------------
-// get ymax of a graphic screen. 0,0 bottom left
+// Product of two 4.12 numbers
+// Input : a, b with |a| < 2.0 and |b| < 2.0 
 // Registers are saved except hl used for result
-// Uses Dai ROM related function
 // return in hl
-uint8_t dai_ymax(void)
+int16_t fx_mul(int16_t a, int16_t b)
 {
 	__asm__(" push af");
 	__asm__(" push bc");
 	__asm__(" push de");
-	__asm__(" ld hl,$0000"); // x in hl
-	__asm__(" ld c,$00"); // y in c
-	__asm__(" rst 5");
-	__asm__(" defb $27"); // call $E884 in ROM, return a=color, b=ymax, de=xmax
-	__asm__(" ld h,$00"); // ymax in hl
-	__asm__(" ld l,b"); 
+	__asm__(" ld hl,$0008");	
+	__asm__(" add hl,sp"); 
+	__asm__(" ld e,(hl)"); // b in de
+	__asm__(" inc hl");
+	__asm__(" ld d,(hl)");
+	__asm__(" inc hl");
+	__asm__(" ld c,(hl)"); // a in bc
+	__asm__(" inc hl");
+	__asm__(" ld b,(hl)");
+	__asm__(" call _fx_mulcore"); // hl = a*b
 	__asm__(" pop de");
 	__asm__(" pop bc");
 	__asm__(" pop af");
@@ -446,31 +1583,30 @@ uint8_t dai_ymax(void)
 
 
 // -----------------------------------------------------------------------------------
-// dai_scrn 
+// fx_mul2 
 // -----------------------------------------------------------------------------------
-// Get color of dot. 0,0 bottom left
-// Input : x, y
+// Double product of two 4.12 numbers (2*a*b), rounded once
+// Input : a, b with |a| < 2.0 and |b| < 2.0 
 // Registers are saved except hl used for result
-// Uses Dai ROM related function
-uint8_t dai_scrn(uint8_t x, uint8_t y)
+// return in hl
+int16_t fx_mul2(int16_t a, int16_t b)
 {
 	__asm__(" push af");
 	__asm__(" push bc");
 	__asm__(" push de");
 	__asm__(" ld hl,$0008");	
 	__asm__(" add hl,sp"); 
-	__asm__(" ld c, (hl)"); // y in c
+	__asm__(" ld e,(hl)"); // b in de
 	__asm__(" inc hl");
+	__asm__(" ld d,(hl)");
 	__asm__(" inc hl");
-	__asm__(" ld a,(hl)"); // x in hl
+	__asm__(" ld c,(hl)"); // a in bc
 	__asm__(" inc hl");
-	__asm__(" ld h,(hl)"); 
-	__asm__(" ld l,a"); 
-	// Input for Dai functions: x = hl, y = c
-	__asm__(" rst 5");
-	__asm__(" defb $27"); // call $E884 in ROM, return a=color, b=ymax, de=xmax
-	__asm__(" ld h,$00"); // color in hl
-	__asm__(" ld l,a"); 
+	__asm__(" ld b,(hl)");
+	__asm__(" ex de,hl"); // de = 2*b
+	__asm__(" add hl,hl");
+	__asm__(" ex de,hl");
+	__asm__(" call _fx_mulcore"); // hl = a*2b
 	__asm__(" pop de");
 	__asm__(" pop bc");
 	__asm__(" pop af");
@@ -478,129 +1614,321 @@ uint8_t dai_scrn(uint8_t x, uint8_t y)
 
 
 // -----------------------------------------------------------------------------------
-// dai_colort 
-// -----------------------------------------------------------------------------------
-// Change text colors (equivalent of colort)
-// Input : color 0,1,2,3 (from 0 to 15)
-// Registers are saved
-// Uses Dai ROM related function
+// fx_sqr 
 // -----------------------------------------------------------------------------------
-void dai_colort(uint8_t C0,uint8_t C1,uint8_t C2,uint8_t C3) {
+// Square of a 4.12 number
+// Input : a with |a| < 2.0 
+// Registers are saved except hl used for result
+// return in hl
+int16_t fx_sqr(int16_t a)
+{
 	__asm__(" push af");
-	__asm__(" push hl");
+	__asm__(" push bc");
 	__asm__(" push de");
 	__asm__(" ld hl,$0008");	
 	__asm__(" add hl,sp"); 
-	__asm__(" ld de,$011C");
-	__asm__(" ld a,(hl)"); // C3, Color 0-15
-	__asm__(" ld (de),a"); 
-	__asm__(" dec de");
-	__asm__(" inc hl");
-	__asm__(" inc hl");
-	__asm__(" ld a,(hl)"); // C2, Color 0-15
-	__asm__(" ld (de),a");
-	__asm__(" dec de");
+	__asm__(" ld e,(hl)"); // a in de
 	__asm__(" inc hl");
-	__asm__(" inc hl");
-	__asm__(" ld a,(hl)"); // C1, Color 0-15
-	__asm__(" ld (de),a");
-	__asm__(" dec de");
-	__asm__(" inc hl");
-	__asm__(" inc hl");
-	__asm__(" ld a,(hl)"); // C0, Color 0-15
-	__asm__(" ld (de),a");
-	__asm__(" ld hl,$0119");
-	__asm__(" rst 5");
-	__asm__(" defb $06"); // call $E237 in ROM, input color vectors (coding 0-15) pointer in hl
+	__asm__(" ld d,(hl)");
+	__asm__(" ld b,d"); // a in bc
+	__asm__(" ld c,e");
+	__asm__(" call _fx_mulcore"); // hl = a*a
 	__asm__(" pop de");
-	__asm__(" pop hl");
+	__asm__(" pop bc");
 	__asm__(" pop af");
 }
 
 
 // -----------------------------------------------------------------------------------
-// dai_cursor 
+// fx_mulcore 
 // -----------------------------------------------------------------------------------
-// Set position of cursor. 0,0 = bottom left
-// Input : x, y 
-// Registers are saved
-// Uses Dai ROM related function
-void dai_cursor(uint8_t x, uint8_t y)
+// Signed multiplication used by fx_mul, fx_mul2 and fx_sqr (not to be called from C)
+// Input : bc = a with |a| < 8192, de = b with |b| < 16384
+// Output : hl = a*b/4096 rounded to nearest
+// Works on absolute values : (|a|*8) * (|b|*2) = 16*|a*b| on 32 bits, upper 16 bits = |a*b|/4096
+// 32 bits product in de (high) and hl (low), multiplier bits are shifted out of de
+// while the product is shifted in (16 loops of shift and add)
+// Modifies af, bc, de
+void fx_mulcore(void)
 {
+	__asm__(" ld a,b"); // sign of result in bit 7
+	__asm__(" xor d");
 	__asm__(" push af");
-	__asm__(" push hl");
-	__asm__(" ld hl,$0006");	
-	__asm__(" add hl,sp"); 
-	__asm__(" ld a, (hl)"); // y in a
-	__asm__(" inc hl");
+	__asm__(" ld a,b"); // bc = |a|
+	__asm__(" or a");
+	__asm__(" jp p,fx_mulcore_pa");
+	__asm__(" cpl");
+	__asm__(" ld b,a");
+	__asm__(" ld a,c");
+	__asm__(" cpl");
+	__asm__(" ld c,a");
+	__asm__(" inc bc");
+	__asm__("fx_mulcore_pa:");
+	__asm__(" ld a,d"); // de = |b|
+	__asm__(" or a");
+	__asm__(" jp p,fx_mulcore_pb");
+	__asm__(" cpl");
+	__asm__(" ld d,a");
+	__asm__(" ld a,e");
+	__asm__(" cpl");
+	__asm__(" ld e,a");
+	__asm__(" inc de");
+	__asm__("fx_mulcore_pb:");
+	__asm__(" ld h,b"); // bc = |a|*8
+	__asm__(" ld l,c");
+	__asm__(" add hl,hl");
+	__asm__(" add hl,hl");
+	__asm__(" add hl,hl");
+	__asm__(" ld b,h");
+	__asm__(" ld c,l");
+	__asm__(" ex de,hl"); // de = |b|*2
+	__asm__(" add hl,hl");
+	__asm__(" ex de,hl");
+	__asm__(" ld hl,$0000"); // low part of product
+	__asm__(" ld a,16"); // loop counter
+	__asm__("fx_mulcore_loop:");
+	__asm__(" add hl,hl"); // shift de:hl left
+	__asm__(" ex de,hl");
+	__asm__(" jp nc,fx_mulcore_nc");
+	__asm__(" add hl,hl"); // carry from low part into high part
 	__asm__(" inc hl");
-	__asm__(" ld l,(hl)"); // x in l
-	__asm__(" ld h,a"); // y in h
-	// Input for Dai functions: h = y, l = x
-	__asm__(" rst 5");
-	__asm__(" defb $09"); // call $E279 in ROM
-	__asm__(" pop hl");
-	__asm__(" pop af");
+	__asm__(" jp fx_mulcore_sh");
+	__asm__("fx_mulcore_nc:");
+	__asm__(" add hl,hl");
+	__asm__("fx_mulcore_sh:");
+	__asm__(" ex de,hl"); // carry = multiplier bit shifted out of de
+	__asm__(" jp nc,fx_mulcore_next");
+	__asm__(" add hl,bc"); // add multiplicand
+	__asm__(" jp nc,fx_mulcore_next");
+	__asm__(" inc de");
+	__asm__("fx_mulcore_next:");
+	__asm__(" dec a");
+	__asm__(" jp nz,fx_mulcore_loop");
+	__asm__(" ld a,h"); // round with bit 15 of low part
+	__asm__(" add a,a");
+	__asm__(" jp nc,fx_mulcore_rd");
+	__asm__(" inc de");
+	__asm__("fx_mulcore_rd:");
+	__asm__(" pop af"); // apply sign
+	__asm__(" or a");
+	__asm__(" jp p,fx_mulcore_pr");
+	__asm__(" ld a,d");
+	__asm__(" cpl");
+	__asm__(" ld d,a");
+	__asm__(" ld a,e");
+	__asm__(" cpl");
+	__asm__(" ld e,a");
+	__asm__(" inc de");
+	__asm__("fx_mulcore_pr:");
+	__asm__(" ex de,hl"); // result in hl
 }
+#endif
 
 
-// -----------------------------------------------------------------------------------
-// dai_curx 
-// -----------------------------------------------------------------------------------
-// get x position of cursor. 0,0 bottom left
-// Registers are saved except hl used for result
-// Uses Dai ROM related function
-// return in l
-uint8_t dai_curx(void)
+
+
+//===================================================================================
+// Cooperative tasks
+//===================================================================================
+// Round robin scheduler of protothreads (see PT_ macros) : each task runs until it
+// yields or waits, so a long computation split in steps (ex: one row) lets other tasks
+// poll the keyboard or update the screen between them, without any stack per task
+
+//-----------------------------------------------------------------------------------
+// task_add
+// ----------------------------------------------------------------------------------
+// Add task f, started at its PT_BEGIN by the next round of task_run
+// Returns 0 if TASK_MAX tasks are already running
+uint8_t task_add(uint8_t (*f)(uint16_t *pt))
 {
-	__asm__(" push de");
-	__asm__(" rst 5");
-	__asm__(" defb $0C"); // call $E2CC in ROM, return h=y, l=x, d=ymax, e=xmax
-	__asm__(" ld h,$00"); // x in l
-	__asm__(" pop de");
+	static uint8_t i;
+
+	for (i = 0; i < TASK_MAX; i++) {
+		if (task_fn[i] == 0) {
+			task_fn[i] = f;
+			task_pt[i] = 0;
+			return 1;
+		}
+	}
+	return 0;
 }
 
 
+//-----------------------------------------------------------------------------------
+// task_run
+// ----------------------------------------------------------------------------------
+// Call each task in turn, remove those returning PT_DONE, return when none is left
+// task_ticks counts the rounds
+void task_run(void)
+{
+	static uint8_t i, n;
+
+	do {
+		n = 0;
+		for (i = 0; i < TASK_MAX; i++) {
+			if (task_fn[i] == 0) continue;
+			if (task_fn[i](&task_pt[i]) == PT_DONE) task_fn[i] = 0;
+			else n++;
+		}
+		task_ticks++;
+	} while (n != 0);
+}
+
+
+
+
+//===================================================================================
+//===================================================================================
+//===================================================================================
+
+#ifdef DAI_PROFILE
+//===================================================================================
+// Profiling
+//===================================================================================
+// The timer interrupt of the DAI goes through the restart vector PROF_VECTOR, which holds
+// a jp to the ROM handler. prof_start replaces the address of this jp by prof_isr, which
+// adds the interrupted program counter (return address on the stack) to a histogram of
+// 256 bins, then jumps to the ROM handler. Samples are taken at the timer rate, so the
+// histogram gives the share of time spent in each part of the program.
+// PROF_ENTER / PROF_EXIT around hot code count calls and samples taken in between.
+// Results are in RAM from PROF_AREA, to be saved (utility W or emulator debugger) and
+// read on the host with tools/dai_prof.c and the .map file of the build (-m)
+
+
 // -----------------------------------------------------------------------------------
-// dai_cury
+// prof_start
 // -----------------------------------------------------------------------------------
-// get y position of cursor = 0,0 bottom left
-// Registers are saved except hl used for result
-// Uses Dai ROM related function
-// return in l
-uint8_t dai_cury(void)
+// Clear the profiling area and chain prof_isr before the ROM interrupt handler
+// Input : lo = address of first bin, shift = size of bins is 2^shift bytes
+// return 1 if started, 0 if the vector does not hold a jp or if the program (with its
+// static variables) goes past PROF_AREA : move PROF_AREA above the end given by the .map
+uint8_t prof_start(uint16_t lo, uint8_t shift)
 {
-	__asm__(" push de");
-	__asm__(" rst 5");
-	__asm__(" defb $0C"); // call $E2CC in ROM, return h=y, l=x, d=ymax, e=xmax
-	__asm__(" ld l,h"); 
-	__asm__(" ld h,$00"); // y in l
-	__asm__(" pop de");
+	static uint16_t i;
+
+	if (*(uint8_t *)PROF_VECTOR != 0xC3) return 0;
+	if (prog_end() > PROF_AREA) return 0; // the area would overwrite the program
+	if (prof_old == 0) prof_old = *(uint16_t *)(PROF_VECTOR + 1);
+	for (i = 0; i < 1040 + 8 * PROF_PROBES; i++) prof_area[i] = 0;
+	prof_area[0] = 'P';
+	prof_area[1] = 'F';
+	*(uint16_t *)(prof_area + 2) = lo;
+	prof_area[4] = shift;
+	prof_area[5] = PROF_PROBES;
+	prof_lo = lo;
+	prof_shift = shift;
+	prof_on = 1;
+	__asm__(" di");
+	*(uint16_t *)(PROF_VECTOR + 1) = (uint16_t)prof_isr;
+	__asm__(" ei");
+	return 1;
 }
 
 
 // -----------------------------------------------------------------------------------
-// dai_clearscreen 
+// prof_stop
 // -----------------------------------------------------------------------------------
-// Clear scren by print character 0x0C
-// Registers are saved
-// Uses Dai ROM related function
-void dai_clearscreen(void)
+// Give the interrupt back to the ROM handler and stop the probes, results stay in the
+// profiling area
+void prof_stop(void)
 {
-	__asm__(" push af"); 
-	__asm__(" ld a, 0x0C"); // Load character 0x12 = clear screen
-	__asm__(" rst 5"); // call $E102 in ROM
-	__asm__(" defb $03");
-	__asm__(" pop af"); 
+	if (prof_old == 0) return;
+	prof_on = 0; // calls counted by the probes match the samples
+	__asm__(" di");
+	*(uint16_t *)(PROF_VECTOR + 1) = prof_old;
+	__asm__(" ei");
 }
 
 
+// -----------------------------------------------------------------------------------
+// prof_isr
+// -----------------------------------------------------------------------------------
+// Interrupt handler : add 1 to the samples and to the bin of the interrupted address
+// (or to samples out of bins), then jump to the ROM handler
+// Registers are saved, 10 bytes of stack
+void prof_isr(void)
+{
+	__asm__(" push af");
+	__asm__(" push hl");
+	__asm__(" push de");
+	__asm__(" push bc");
+	__asm__(" ld hl,(_prof_area)"); // samples
+	__asm__(" ld de,$0008");
+	__asm__(" add hl,de");
+	__asm__(" call prof_inc32");
+	__asm__(" ld hl,$0008"); // interrupted address in de
+	__asm__(" add hl,sp");
+	__asm__(" ld e,(hl)");
+	__asm__(" inc hl");
+	__asm__(" ld d,(hl)");
+	__asm__(" ld hl,(_prof_lo)"); // de = address - lo
+	__asm__(" ld a,e");
+	__asm__(" sub l");
+	__asm__(" ld e,a");
+	__asm__(" ld a,d");
+	__asm__(" sbc a,h");
+	__asm__(" ld d,a");
+	__asm__(" jp c,prof_isr_out");
+	__asm__(" ld a,(_prof_shift)"); // de = bin
+	__asm__(" ld b,a");
+	__asm__(" inc b");
+	__asm__("prof_isr_sh:");
+	__asm__(" dec b");
+	__asm__(" jp z,prof_isr_bin");
+	__asm__(" ld a,d");
+	__asm__(" or a");
+	__asm__(" rra");
+	__asm__(" ld d,a");
+	__asm__(" ld a,e");
+	__asm__(" rra");
+	__asm__(" ld e,a");
+	__asm__(" jp prof_isr_sh");
+	__asm__("prof_isr_bin:");
+	__asm__(" ld a,d"); // 256 bins
+	__asm__(" or a");
+	__asm__(" jp nz,prof_isr_out");
+	__asm__(" ld h,a"); // hl = area + 16 + 4 * bin
+	__asm__(" ld l,e");
+	__asm__(" add hl,hl");
+	__asm__(" add hl,hl");
+	__asm__(" ld de,$0010");
+	__asm__(" add hl,de");
+	__asm__(" ex de,hl");
+	__asm__(" ld hl,(_prof_area)");
+	__asm__(" add hl,de");
+	__asm__(" jp prof_isr_inc");
+	__asm__("prof_isr_out:");
+	__asm__(" ld hl,(_prof_area)"); // samples out of bins
+	__asm__(" ld de,$000C");
+	__asm__(" add hl,de");
+	__asm__("prof_isr_inc:");
+	__asm__(" call prof_inc32");
+	__asm__(" pop bc");
+	__asm__(" pop de");
+	__asm__(" pop hl");
+	__asm__(" pop af");
+	__asm__(" push hl"); // jump to ROM handler, hl kept
+	__asm__(" ld hl,(_prof_old)");
+	__asm__(" ex (sp),hl");
+	__asm__(" ret");
+	// 32 bits counter at hl
+	__asm__("prof_inc32:");
+	__asm__(" inc (hl)");
+	__asm__(" ret nz");
+	__asm__(" inc hl");
+	__asm__(" inc (hl)");
+	__asm__(" ret nz");
+	__asm__(" inc hl");
+	__asm__(" inc (hl)");
+	__asm__(" ret nz");
+	__asm__(" inc hl");
+	__asm__(" inc (hl)");
+	__asm__(" ret");
+}
+#endif
 
 
-//===================================================================================
-//===================================================================================
-//===================================================================================
-
+#ifndef DAI_HOST
 //===================================================================================
 // Functions for debugging stack registers
 //===================================================================================
@@ -656,6 +1984,19 @@ uint16_t get_SP(void)
 }
 
 
+// -----------------------------------------------------------------------------------
+// prog_end
+// -----------------------------------------------------------------------------------
+// Get the first byte after the program : end of the last section (BSS_END) given by the
+// linker, also shown in the .map file (__BSS_END_tail)
+// Used to check that RAM areas at fixed addresses are above the program
+// returns the address in hl
+uint16_t prog_end(void)
+{
+	__asm__(" ld hl,__BSS_END_tail");
+}
+
+
 // -----------------------------------------------------------------------------------
 // change_Stack
 // -----------------------------------------------------------------------------------
@@ -679,4 +2020,5 @@ void change_Stack(void)
 	__asm__(" ld sp,hl");		
 	__asm__(" pop hl");
 	__asm__(" pop de");
-}
\ No newline at end of file
+}
+#endif
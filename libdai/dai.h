@@ -0,0 +1,268 @@
+//====================================================================================
+// libdai : C interfaces to the DAI ROM graphic and text functions, native screen functions
+//====================================================================================
+// One source file per function : the library has one object per function and a program
+// links only the functions it uses (and the variables of dai_vars.c).
+// Build the library with z88dk, from the root of the repository :
+// zcc.exe +dai -x -o libdai/dai @libdai/dai.lst
+// Use it : #include "libdai/dai.h" in the program, then link with the library
+// zcc.exe +dai -m -create-app ... a.c -Llibdai -ldai
+// or compile the sources with the program, without building the library
+// zcc.exe +dai -m -create-app ... a.c @libdai/dai.lst
+// Compilation options below change the library : build it again after changing them.
+// Variables reached from "__asm__" code are declared here, so that every object sees them.
+// "__asm__" 8080 mnemonics are in Z80 style due to z88 compiler requirements
+// No purely Z80 mnemonic is used
+#ifndef DAI_H
+#define DAI_H
+
+#include <stdint.h>
+
+// Host build (tools/dai_host.c) : no z88dk calling conventions, DAI memory in an array
+#ifdef DAI_HOST
+#define __z88dk_callee
+#define __z88dk_fastcall
+extern uint8_t dai_hmem[0x10000]; // DAI address space of the host build
+#define DAI_ADDR(a) (&dai_hmem[a])
+#else
+#define DAI_ADDR(a) ((uint8_t *)(a)) // Address a of the DAI memory
+#endif
+
+
+//====================================================================================
+// Compilation options
+//====================================================================================
+// #define DAI_VDRAW_NATIVESLOPES // Uncomment to draw lines which are not horizontal, vertical or diagonal with Bresenham instead of the ROM
+// #define DAI_BACKBUFFER // Uncomment to let native functions draw in a RAM buffer copied to the screen by dai_bbflush
+
+
+//====================================================================================
+// Function declarations
+//====================================================================================
+
+// -----------------------------------------------------------------------------------
+// Functions to emulate Dai basic commands
+// -----------------------------------------------------------------------------------
+// differences from basic commands : no error is returned 
+void dai_mode(uint8_t m); // change graphic modes
+void dai_colorg(uint8_t C0,uint8_t C1,uint8_t C2,uint8_t C3); // Default graphic colors for 4 color mode
+void dai_dot(uint16_t x, uint8_t y, uint8_t c); // Plot a dot
+void dai_draw(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint8_t c); // Plot a line
+void dai_fill(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint8_t c); // Plot a rectangle
+uint16_t dai_xmax(void); // Get max x of current graphic mode (from the graphics context once set by dai_mode)
+uint8_t dai_ymax(void); // Get max y of current graphic mode (from the graphics context once set by dai_mode)
+uint8_t dai_scrn(uint16_t x, uint8_t y);  // Get color of a dot in graphic mode
+
+void dai_colort(uint8_t C0,uint8_t C1,uint8_t C2,uint8_t C3); // Default text colors
+void dai_cursor(uint8_t x, uint8_t y); // Set cursor position in text mode
+void dai_clearscreen(void); // Clear screen in text mode by sending charater 0x12 
+uint8_t dai_curx(void); // Get cursor x position in text mode
+uint8_t dai_cury(void); // Get cursor y position in text mode
+uint16_t dai_textmax(void); // Get max y (high byte) and max x (low byte) of cursor in current mode
+void dai_putchar(uint8_t c); // Print a character (or control character) at cursor position
+
+
+// -----------------------------------------------------------------------------------
+// Register passing variants, arguments are loaded directly in the registers used by the ROM
+// -----------------------------------------------------------------------------------
+// Same functions as above with z88dk register calling conventions :
+// - __z88dk_callee : arguments are popped by the function directly into the registers
+//   expected by the ROM (no offset from sp, no stack cleaning by the caller)
+// - __z88dk_fastcall : the only argument is in hl
+// Registers are not saved, the compiler does not require it
+//
+// Overhead of a call in T states (8080), without ROM routine and argument pushes :
+// function       standard   register   (standard = wrapper + stack cleaning by caller)
+// dai_mode         203         53      (dai_vinit excluded)
+// dai_colorg       292        170      (dai_vpalette excluded)
+// dai_dot          198         83
+// dai_draw         301        128
+// dai_fill         301        128
+// dai_scrn         183         77
+// dai_colort       271        170
+// dai_cursor       138         73
+// dai_vdot         235         83      (dai_vdot_reg excluded)
+// Counted from 8080 timings, ROM routines excluded, caller cleaning with one pop per argument
+// dai_xmax, dai_ymax, dai_curx, dai_cury, dai_clearscreen have no argument and no variant
+void dai_mode_fastcall(uint8_t m) __z88dk_fastcall;
+void dai_colorg_callee(uint8_t C0,uint8_t C1,uint8_t C2,uint8_t C3) __z88dk_callee;
+void dai_dot_callee(uint16_t x, uint8_t y, uint8_t c) __z88dk_callee;
+void dai_draw_callee(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint8_t c) __z88dk_callee;
+void dai_fill_callee(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint8_t c) __z88dk_callee;
+uint8_t dai_scrn_callee(uint16_t x, uint8_t y) __z88dk_callee;
+void dai_colort_callee(uint8_t C0,uint8_t C1,uint8_t C2,uint8_t C3) __z88dk_callee;
+void dai_cursor_callee(uint8_t x, uint8_t y) __z88dk_callee;
+
+
+// -----------------------------------------------------------------------------------
+// Native screen functions (direct access to screen memory, ROM used as fallback)
+// -----------------------------------------------------------------------------------
+// Screen memory is a list of lines read downward from $BFFF, each line is :
+// - mode byte : bits 7-6 display mode (00 = 4 colors graphic, 10 = 16 colors graphic,
+//   x1 = characters), bits 5-4 resolution (88, 176, 352 or 528 dots), bits 3-0 repeat count
+// - color byte : bit 6 cleared for unit color lines (whole line with one color)
+// - pairs of data bytes, 8 dots each, first dot in bit 7, one pair on each side is not used
+//   4 colors : palette index bit 0 in first byte, bit 1 in second byte
+//   16 colors : first byte selects for each dot one of the two colors of the second byte
+// dai_vinit locates the rows of the graphic area, then native functions write directly in
+// screen memory. Whenever the result could differ from the ROM (dot out of screen, unit color
+// line, color not in palette, 16 colors block without the requested color) the ROM is used.
+void dai_vinit(uint8_t m); // Build rows table of graphic mode m (called by dai_mode)
+void dai_vpalette(void); // Update color to palette index table (called by dai_colorg)
+void dai_vdot(uint16_t x, uint8_t y, uint8_t c); // Plot a dot, same result as dai_dot
+void dai_vdot_callee(uint16_t x, uint8_t y, uint8_t c) __z88dk_callee; // Same as dai_vdot, registers not saved
+void dai_vdot_reg(void); // Internal, registers interface of ROM dot : hl = x, c = y, a = color
+uint8_t dai_vscrn(uint16_t x, uint8_t y); // Get color of a dot, same result as dai_scrn
+uint8_t dai_vget(uint8_t *row, uint16_t x); // Get color of a dot of a row in screen memory
+void dai_dots(uint16_t x, uint8_t y, uint16_t n, uint8_t *buf); // Plot n dots of a row from a color buffer
+uint16_t dai_vspan4(uint8_t *row, uint16_t x, uint16_t n, uint8_t *buf); // Internal, 4 colors span of dai_dots
+void dai_vdraw(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint8_t c); // Plot a line, same result as dai_draw
+void dai_vfill(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint8_t c); // Plot a rectangle, same result as dai_fill
+void dai_vclear(uint8_t c); // Fill the whole graphic screen with a color
+void dai_vhspan4(uint8_t *row, uint16_t x0, uint16_t x1, uint8_t pt0, uint8_t pt1); // Internal, 4 colors horizontal span
+void dai_vput4(uint8_t *p, uint8_t mk, uint8_t pt0, uint8_t pt1); // Internal, 4 colors dots of a mask in a pair
+void dai_vbytes(uint8_t *p, uint16_t n, uint8_t pt0, uint8_t pt1); // Internal, 4 colors n whole pairs
+uint8_t dai_vunpack(uint8_t *img); // Show a screen image of tools/dai_scr.c, sets its colors and mode
+uint8_t *dai_vunrow(uint8_t *src, uint8_t *dst, uint16_t delta, uint8_t n); // Internal, one row of dai_vunpack
+void dai_vcopy(uint8_t *dst, uint8_t *src, uint16_t n); // Internal, copy n bytes downward
+
+
+// -----------------------------------------------------------------------------------
+// Curves (integer midpoint algorithms, native functions for dots and spans)
+// -----------------------------------------------------------------------------------
+// Circles use the 8-way symmetry, ellipses the 4-way one : only one eighth or one quarter
+// is computed, with 16 bits (circle) or 32 bits (ellipse) integers, no floating point.
+// Filled curves are written with one horizontal span per row (dai_vfill), outlines with
+// dai_vdot. Centers and radii may put dots out of screen : they are not drawn.
+void dai_circle(uint16_t xc, uint8_t yc, uint8_t r, uint8_t c); // Draw a circle
+void dai_circlefill(uint16_t xc, uint8_t yc, uint8_t r, uint8_t c); // Draw a filled circle
+void dai_arc(uint16_t xc, uint8_t yc, uint8_t r, uint8_t oct, uint8_t c); // Draw octants of a circle (bit n of oct : n * 45 to (n + 1) * 45 degrees)
+void dai_ellipse(uint16_t xc, uint8_t yc, uint8_t rx, uint8_t ry, uint8_t c); // Draw an ellipse (rx * ry at most 40000)
+void dai_ellipsefill(uint16_t xc, uint8_t yc, uint8_t rx, uint8_t ry, uint8_t c); // Draw a filled ellipse (rx * ry at most 40000)
+void dai_vellipse(uint16_t xc, uint8_t yc, uint8_t rx, uint8_t ry, uint8_t fill, uint8_t c); // Internal, ellipse or filled ellipse
+void dai_vcdot(int16_t x, int16_t y, uint8_t c); // Internal, dot drawn only if on the screen
+void dai_vcspan(int16_t x0, int16_t x1, int16_t y, uint8_t c); // Internal, span of a row clipped to the screen
+
+
+// -----------------------------------------------------------------------------------
+// Area fills (horizontal spans written with dai_vfill, no recursion)
+// -----------------------------------------------------------------------------------
+// dai_fill_polygon scans the rows of the polygon with an edge table and an active edge list
+// in static arrays of DAI_PEDGES edges. dai_flood_fill reads the screen with dai_vscrn and
+// keeps its seeds in a buffer given by the caller, out of the 128 bytes stack.
+#define DAI_PEDGES 32 // Max vertices of dai_fill_polygon
+
+uint8_t dai_fill_polygon(uint8_t n, uint16_t *x, uint8_t *y, uint8_t c); // Draw a filled polygon of n vertices, returns 0 if not possible
+uint8_t dai_flood_fill(uint16_t x, uint8_t y, uint8_t c, uint8_t *buf, uint16_t size); // Fill the area of the color of x,y, seeds in buf, returns 0 if not done
+
+
+// -----------------------------------------------------------------------------------
+// Sprites (masked bitmaps pre-shifted by dai_sprmake, drawn by dai_blit)
+// -----------------------------------------------------------------------------------
+// A sprite keeps 8 copies of its dots, shifted by 0 to 7 dots, as mask and bits of the
+// two bytes of the pairs of a 4 colors mode : dai_blit writes whole pairs from the copy
+// of x & 7 without any shift. It is made once, when loaded, with the colors set by
+// dai_colorg. 16 colors modes and pairs out of the right side are drawn dot by dot, with
+// the result of dai_dot (in 16 colors modes, only 2 colors in each block of 8 dots).
+// A save buffer keeps what is under the sprite, dai_unblit puts it back.
+#define DAI_SPRCOLS(w) (((w) + 7) / 8 + 1) // Pairs of a row of a sprite of width w, any shift
+#define DAI_SPRSIZE(w, h) (3 + 24 * (h) * DAI_SPRCOLS(w)) // Bytes of a sprite of w * h dots
+#define DAI_SAVESIZE(w, h) ((h) * (((w) > 2 * DAI_SPRCOLS(w) ? (w) : 2 * DAI_SPRCOLS(w)) + 1)) // Bytes of a save buffer of dai_blit
+
+uint8_t dai_sprmake(uint8_t *spr, uint8_t w, uint8_t h, uint8_t *dots); // Make a sprite from w * h colors (0xFF transparent), returns 0 if a color is not in the palette
+void dai_blit(uint8_t *spr, uint16_t x, uint8_t y, uint8_t *save); // Draw a sprite, x, y top left, keeps what is under it in save (or 0)
+void dai_unblit(uint8_t *spr, uint16_t x, uint8_t y, uint8_t *save); // Put back what was under a sprite drawn by dai_blit
+uint8_t *dai_vblit4(uint8_t *p, uint8_t *s, uint8_t n); // Internal, 4 colors row of dai_blit, returns next row of the sprite
+
+
+// -----------------------------------------------------------------------------------
+// Native text functions
+// -----------------------------------------------------------------------------------
+// Text lines are lines of the screen memory with bit 6 of the mode byte set, one line of
+// screen memory for each line of characters. The order of character and color bytes is
+// not documented : dai_tinit finds it by printing two characters with the ROM and looking
+// for the bytes which changed, then restores the line.
+// dai_puts writes printable characters directly in screen memory and moves the cursor
+// once per string with the ROM. Control characters, the last column (line wrap and
+// scroll) and modes where the lines are not found are left to the ROM.
+void dai_tinit(void); // Find text lines in screen memory (called by dai_puts when needed)
+void dai_puts(char *str); // Print a string at cursor position, characters written in screen memory
+void dai_print_uint(uint16_t v); // Print an unsigned integer in decimal, same as dai_puts
+
+
+// -----------------------------------------------------------------------------------
+// Back buffer (native functions draw in RAM, dirty rectangles copied to the screen)
+// -----------------------------------------------------------------------------------
+// 4 colors modes only. Each row of the buffer has the layout of a screen row : color
+// byte (unit color bit set, the row is never unit color), unused pair, then the pairs
+// of data bytes downward. dai_bbon points dai_vrow to the rows of the buffer, so all
+// native functions (dai_vdot, dai_dots, dai_vdraw, dai_vfill, dai_vclear, dai_vscrn)
+// draw in and read from the buffer without any change.
+// Native functions add the rectangle they change to a short list, dai_bbflush copies
+// the pairs of these rectangles to the screen.
+// Dots which native functions leave to the ROM (out of screen, color not in palette)
+// are still drawn directly on the screen. ROM functions (dai_dot, dai_draw, dai_fill,
+// dai_scrn) still work on the screen.
+// Buffer size for a mode : (ymax + 1) * (2 * ((xmax + 8) / 8) + 3) bytes, 22272 for 0x0B
+#ifdef DAI_BACKBUFFER
+uint8_t dai_bbon(uint8_t *buf, uint16_t size); // Start drawing in buf, returns 0 if not possible
+void dai_bbflush(void); // Copy dirty rectangles of the buffer to the screen
+void dai_bboff(void); // Flush and draw again on the screen
+void dai_bbdirty(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1); // Internal, add a dirty rectangle
+#endif
+
+
+//====================================================================================
+// Global variables (defined in dai_vars.c)
+//====================================================================================
+
+// -----------------------------------------------------------------------------------
+// Graphics context : native screen state, set by dai_vinit (called by dai_mode) and
+// dai_vpalette (called by dai_colorg), read by dai_xmax, dai_ymax and native functions
+// -----------------------------------------------------------------------------------
+#define DAI_VSCANS 604 // Scan lines described by screen memory (PAL)
+#define DAI_VLINES 300 // Max graphic lines collected by dai_vinit
+
+extern uint8_t dai_vmode; // Graphic mode set by dai_mode, 0xFF for text or not set
+extern uint8_t dai_vok; // 1 when native functions can write in screen memory
+extern uint8_t dai_v16; // 1 for 16 colors modes, 0 for 4 colors modes
+extern uint8_t dai_vhi; // 16 colors modes : 1 when dots set in pattern byte use high nibble of color byte
+extern uint16_t dai_vxmax; // xmax of current graphic mode
+extern uint8_t dai_vymax; // ymax of current graphic mode
+extern uint8_t *dai_vrow[DAI_VLINES]; // Address of first data byte of each row, row 0 at bottom
+extern uint8_t *dai_vlow; // Lowest address of screen memory (last byte of the bottom line)
+extern uint8_t dai_vmask[8]; // Bit of each dot in a byte
+extern uint8_t dai_vpairs[4]; // Data byte pairs of a line for each resolution
+extern uint8_t dai_palette[4]; // Colors set by dai_colorg (reset values)
+extern uint8_t dai_vidx[16]; // Palette index of each color, 0xFF if not in palette
+
+
+// -----------------------------------------------------------------------------------
+// Native text state, set by dai_tinit
+// -----------------------------------------------------------------------------------
+#define DAI_TLINES 24 // Max text lines collected by dai_tinit
+
+extern uint8_t dai_tok; // 1 when dai_puts can write in screen memory, reset by dai_vinit and dai_colort
+extern uint8_t dai_ttried; // 1 once dai_tinit has run, even if it failed, reset with dai_tok
+extern uint8_t dai_tn; // Number of text lines
+extern uint8_t dai_txmax; // Last column
+extern uint8_t *dai_trow[DAI_TLINES]; // Address of the character of column 0 of each text line, line 0 at bottom
+extern int8_t dai_tstep; // Address step from a column to the next one
+extern int8_t dai_tattr; // Offset of the color byte from the character byte, 0 if none
+extern uint8_t dai_tcolor; // Color byte written by the ROM with characters
+
+
+// -----------------------------------------------------------------------------------
+// Back buffer state, set by dai_bbon
+// -----------------------------------------------------------------------------------
+#ifdef DAI_BACKBUFFER
+#define DAI_BBRECTS 8 // Max dirty rectangles, more are merged
+
+extern uint8_t dai_bbact; // 1 when dai_vrow points to the rows of the back buffer
+extern uint8_t *dai_bbscr[256]; // Screen rows while the back buffer is active
+extern uint8_t dai_bbn; // Number of dirty rectangles
+extern uint16_t dai_bbx0[DAI_BBRECTS], dai_bbx1[DAI_BBRECTS]; // Dirty rectangles
+extern uint8_t dai_bby0[DAI_BBRECTS], dai_bby1[DAI_BBRECTS];
+#endif
+
+#endif
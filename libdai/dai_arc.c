@@ -0,0 +1,42 @@
+//====================================================================================
+// libdai : dai_arc
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_arc 
+// -----------------------------------------------------------------------------------
+// Draw the octants of a circle given by a mask, integer midpoint algorithm
+// One eighth of the circle is computed, each point gives one dot in each octant of the mask
+// Octant n goes from n * 45 degrees to (n + 1) * 45 degrees counterclockwise, 0 starts
+// on the right of the center (y grows upward, row 0 at bottom) :
+// bit 0 = 0-45, bit 1 = 45-90, ... bit 7 = 315-360, ex: 0x0F upper half, 0xFF whole circle
+// Dots out of screen are not drawn
+// Input : center xc, yc, radius r, octants mask oct, color
+void dai_arc(uint16_t xc, uint8_t yc, uint8_t r, uint8_t oct, uint8_t c)
+{
+	static int16_t x, y, d, cx, cy;
+
+	cx = xc;
+	cy = yc;
+	x = r;
+	y = 0;
+	d = 1 - x;
+	while (y <= x) {
+		if (oct & 0x01) dai_vcdot(cx + x, cy + y, c);
+		if (oct & 0x02) dai_vcdot(cx + y, cy + x, c);
+		if (oct & 0x04) dai_vcdot(cx - y, cy + x, c);
+		if (oct & 0x08) dai_vcdot(cx - x, cy + y, c);
+		if (oct & 0x10) dai_vcdot(cx - x, cy - y, c);
+		if (oct & 0x20) dai_vcdot(cx - y, cy - x, c);
+		if (oct & 0x40) dai_vcdot(cx + y, cy - x, c);
+		if (oct & 0x80) dai_vcdot(cx + x, cy - y, c);
+		if (d < 0) d += 2 * y + 3;
+		else {
+			d += 2 * (y - x) + 5; // y - x <= 0 : not a shift
+			x--;
+		}
+		y++;
+	}
+}
@@ -0,0 +1,60 @@
+//====================================================================================
+// libdai : dai_bbdirty
+//====================================================================================
+#include "dai.h"
+
+
+#ifdef DAI_BACKBUFFER
+// -----------------------------------------------------------------------------------
+// dai_bbdirty 
+// -----------------------------------------------------------------------------------
+// Add a rectangle to the dirty list, called by native functions
+// The rectangle is merged with one it overlaps or touches, when the list is full
+// with the one growing the least (width + height)
+// Input : x0, y0, x1, y1 in any order, clipped to the screen
+void dai_bbdirty(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1)
+{
+	static uint16_t t, g, gb;
+	static uint8_t i, b;
+
+	if (x0 > x1) {
+		t = x0;
+		x0 = x1;
+		x1 = t;
+	}
+	if (y0 > y1) {
+		t = y0;
+		y0 = y1;
+		y1 = t;
+	}
+	if ((x0 > dai_vxmax) | (y0 > dai_vymax)) return;
+	if (x1 > dai_vxmax) x1 = dai_vxmax;
+	if (y1 > dai_vymax) y1 = dai_vymax;
+	b = 0;
+	gb = 0xFFFF;
+	for (i = 0; i < dai_bbn; i++) {
+		if ((x0 <= dai_bbx1[i] + 1) & (x1 + 1 >= dai_bbx0[i]) & (y0 <= dai_bby1[i] + 1) & (y1 + 1 >= dai_bby0[i])) {
+			b = i;
+			break;
+		}
+		g = (x0 < dai_bbx0[i] ? dai_bbx0[i] - x0 : 0) + (x1 > dai_bbx1[i] ? x1 - dai_bbx1[i] : 0)
+			+ (y0 < dai_bby0[i] ? dai_bby0[i] - y0 : 0) + (y1 > dai_bby1[i] ? y1 - dai_bby1[i] : 0);
+		if (g < gb) {
+			gb = g;
+			b = i;
+		}
+	}
+	if ((i == dai_bbn) & (dai_bbn < DAI_BBRECTS)) { // new rectangle
+		dai_bbx0[i] = x0;
+		dai_bbx1[i] = x1;
+		dai_bby0[i] = y0;
+		dai_bby1[i] = y1;
+		dai_bbn++;
+		return;
+	}
+	if (x0 < dai_bbx0[b]) dai_bbx0[b] = x0;
+	if (x1 > dai_bbx1[b]) dai_bbx1[b] = x1;
+	if (y0 < dai_bby0[b]) dai_bby0[b] = y0;
+	if (y1 > dai_bby1[b]) dai_bby1[b] = y1;
+}
+#endif
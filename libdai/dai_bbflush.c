@@ -0,0 +1,33 @@
+//====================================================================================
+// libdai : dai_bbflush
+//====================================================================================
+#include "dai.h"
+
+
+#ifdef DAI_BACKBUFFER
+// -----------------------------------------------------------------------------------
+// dai_bbflush 
+// -----------------------------------------------------------------------------------
+// Copy the dirty rectangles of the back buffer to the screen, whole pairs of each row
+// Unit color lines of the screen are first changed by a ROM dot
+void dai_bbflush(void)
+{
+	static uint16_t x, off, n;
+	static uint8_t i, y;
+
+	if (dai_bbact == 0) return;
+	for (i = 0; i < dai_bbn; i++) {
+		off = ((dai_bbx0[i] + 8) >> 3) << 1; // first pair
+		n = (((dai_bbx1[i] + 8) >> 3) << 1) - off + 2; // bytes
+		for (y = dai_bby0[i]; ; y++) {
+			if ((dai_bbscr[y][1] & 0x40) == 0) dai_dot(dai_bbx0[i], y, dai_vget(dai_vrow[y], dai_bbx0[i])); // unit color line
+			if (dai_bbscr[y][1] & 0x40) dai_vcopy(dai_bbscr[y] - off, dai_vrow[y] - off, n);
+			else { // still unit color : all dots with the ROM
+				for (x = dai_bbx0[i] + 1; x <= dai_bbx1[i]; x++) dai_dot(x, y, dai_vget(dai_vrow[y], x));
+			}
+			if (y == dai_bby1[i]) break;
+		}
+	}
+	dai_bbn = 0;
+}
+#endif
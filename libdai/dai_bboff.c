@@ -0,0 +1,24 @@
+//====================================================================================
+// libdai : dai_bboff
+//====================================================================================
+#include "dai.h"
+
+
+#ifdef DAI_BACKBUFFER
+// -----------------------------------------------------------------------------------
+// dai_bboff 
+// -----------------------------------------------------------------------------------
+// Flush the back buffer and draw again on the screen
+void dai_bboff(void)
+{
+	static uint8_t y;
+
+	if (dai_bbact == 0) return;
+	dai_bbflush();
+	for (y = 0; ; y++) {
+		dai_vrow[y] = dai_bbscr[y];
+		if (y == dai_vymax) break;
+	}
+	dai_bbact = 0;
+}
+#endif
@@ -0,0 +1,43 @@
+//====================================================================================
+// libdai : dai_bbon
+//====================================================================================
+#include "dai.h"
+
+
+#ifdef DAI_BACKBUFFER
+// -----------------------------------------------------------------------------------
+// dai_bbon 
+// -----------------------------------------------------------------------------------
+// Start drawing in a back buffer, the buffer is set with the content of the screen
+// Input : buf, size of buf in bytes
+// return 1 if done, 0 if not possible (text, 16 colors mode, buffer too small)
+uint8_t dai_bbon(uint8_t *buf, uint16_t size)
+{
+	static uint16_t w;
+	static uint8_t y, idx, pt0, pt1;
+	static uint8_t *r;
+
+	if (dai_bbact) dai_bboff();
+	if ((dai_vok == 0) | dai_v16) return 0;
+	w = (((dai_vxmax + 8) >> 3) << 1) + 3; // bytes of a row
+	if (size / w <= dai_vymax) return 0;
+	for (y = 0; ; y++) {
+		r = buf + y * w + w - 2; // first data byte of the row
+		r[1] = 0x40;
+		dai_bbscr[y] = dai_vrow[y];
+		if (dai_vrow[y][1] & 0x40) dai_vcopy(r - 2, dai_vrow[y] - 2, w - 3);
+		else { // unit color line : color of the whole row
+			idx = dai_vidx[dai_scrn(0, y) & 0x0F];
+			if (idx == 0xFF) idx = 0;
+			pt0 = ((idx & 1) ? 0xFF : 0x00);
+			pt1 = ((idx & 2) ? 0xFF : 0x00);
+			dai_vbytes(r - 2, (w - 3) >> 1, pt0, pt1);
+		}
+		dai_vrow[y] = r;
+		if (y == dai_vymax) break;
+	}
+	dai_bbn = 0;
+	dai_bbact = 1;
+	return 1;
+}
+#endif
@@ -0,0 +1,61 @@
+//====================================================================================
+// libdai : dai_blit
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_blit 
+// -----------------------------------------------------------------------------------
+// Draw a sprite made by dai_sprmake, transparent dots keep the screen
+// 4 colors modes : each row is written with dai_vblit4 from the copy shifted by x & 7,
+// whole pairs and no shift. Rows crossing the right side of the screen, unit color lines
+// and 16 colors modes are drawn dot by dot with dai_vdot
+// With a save buffer, what is under the sprite is kept first for dai_unblit : a byte
+// telling how the row was drawn, then the pairs (dai_vcopy) or the colors of the dots
+// Rows out of screen are not drawn
+// Input : spr, x, y of the top left dot, save = buffer of DAI_SAVESIZE(w, h) bytes or 0
+void dai_blit(uint8_t *spr, uint16_t x, uint8_t y, uint8_t *save)
+{
+	static uint8_t *s, *p, *sv;
+	static uint16_t xx;
+	static uint8_t w, h, cols, stride, sh, nat, r, row, i, k, mk;
+
+	if ((dai_vmode == 0xFF) | (x > dai_vxmax)) return;
+	w = spr[0];
+	h = spr[1];
+	cols = spr[2];
+	stride = (w > 2 * cols ? w : 2 * cols) + 1;
+	sh = x & 7;
+	s = spr + 3 + (uint16_t)sh * h * cols * 3;
+	nat = (dai_vok != 0) & (dai_v16 == 0) & (x + w - 1 <= dai_vxmax);
+#ifdef DAI_BACKBUFFER
+	if (dai_bbact & (y <= dai_vymax)) dai_bbdirty(x, (y >= h ? y - h + 1 : 0), (x + w - 1 <= dai_vxmax ? x + w - 1 : dai_vxmax), y);
+#endif
+	sv = save;
+	row = y;
+	for (r = 0; r < h; r++, row--) {
+		if (row <= dai_vymax) {
+			if (nat && (dai_vrow[row][1] & 0x40)) {
+				p = dai_vrow[row] - (((x + 8) >> 3) << 1);
+				if (save) {
+					sv[0] = 1;
+					dai_vcopy(sv + 2 * cols, p, 2 * cols);
+				}
+				dai_vblit4(p, s, cols);
+			} else { // dot by dot, dai_vdot uses the ROM when needed
+				if (save) sv[0] = 0;
+				for (i = 0; (i < w) && (x + i <= dai_vxmax); i++) {
+					xx = x + i;
+					if (save) sv[i + 1] = dai_vscrn(xx, row);
+					k = 3 * ((i + sh) >> 3);
+					mk = dai_vmask[(i + sh) & 7];
+					if (s[k] & mk) dai_vdot(xx, row, dai_palette[((s[k + 1] & mk) ? 1 : 0) | ((s[k + 2] & mk) ? 2 : 0)]);
+				}
+			}
+		}
+		if (row == 0) break;
+		s += 3 * cols;
+		sv += stride;
+	}
+}
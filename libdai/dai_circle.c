@@ -0,0 +1,16 @@
+//====================================================================================
+// libdai : dai_circle
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_circle 
+// -----------------------------------------------------------------------------------
+// Draw a circle, all octants of dai_arc
+// Dots out of screen are not drawn
+// Input : center xc, yc, radius r, color
+void dai_circle(uint16_t xc, uint8_t yc, uint8_t r, uint8_t c)
+{
+	dai_arc(xc, yc, r, 0xFF, c);
+}
@@ -0,0 +1,39 @@
+//====================================================================================
+// libdai : dai_circlefill
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_circlefill 
+// -----------------------------------------------------------------------------------
+// Draw a filled circle, same dots as dai_circle and all dots inside
+// Same midpoint steps as dai_arc, each point gives the ends of the spans of two rows
+// (y and -y) and, when x is about to change, of two other rows (x and -x) : each row is
+// written once, with dai_vcspan
+// Dots out of screen are not drawn
+// Input : center xc, yc, radius r, color
+void dai_circlefill(uint16_t xc, uint8_t yc, uint8_t r, uint8_t c)
+{
+	static int16_t x, y, d, cx, cy;
+
+	cx = xc;
+	cy = yc;
+	x = r;
+	y = 0;
+	d = 1 - x;
+	while (y <= x) {
+		dai_vcspan(cx - x, cx + x, cy + y, c);
+		if (y != 0) dai_vcspan(cx - x, cx + x, cy - y, c);
+		if (d < 0) d += 2 * y + 3;
+		else {
+			if (x != y) { // last point with this x : its row is as wide as y
+				dai_vcspan(cx - y, cx + y, cy + x, c);
+				dai_vcspan(cx - y, cx + y, cy - x, c);
+			}
+			d += 2 * (y - x) + 5; // y - x <= 0 : not a shift
+			x--;
+		}
+		y++;
+	}
+}
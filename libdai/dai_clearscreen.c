@@ -0,0 +1,20 @@
+//====================================================================================
+// libdai : dai_clearscreen
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_clearscreen 
+// -----------------------------------------------------------------------------------
+// Clear scren by print character 0x0C
+// Registers are saved
+// Uses Dai ROM related function
+void dai_clearscreen(void)
+{
+	__asm__(" push af"); 
+	__asm__(" ld a, 0x0C"); // Load character 0x12 = clear screen
+	__asm__(" rst 5"); // call $E102 in ROM
+	__asm__(" defb $03");
+	__asm__(" pop af"); 
+}
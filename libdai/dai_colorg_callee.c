@@ -0,0 +1,31 @@
+//====================================================================================
+// libdai : dai_colorg_callee
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_colorg_callee
+// -----------------------------------------------------------------------------------
+// Same as dai_colorg
+void dai_colorg_callee(uint8_t C0,uint8_t C1,uint8_t C2,uint8_t C3) __z88dk_callee {
+	__asm__(" pop bc"); // return address
+	__asm__(" pop hl"); // C3, Color 0-15
+	__asm__(" ld a,l");
+	__asm__(" ld ($011C),a");
+	__asm__(" pop hl"); // C2
+	__asm__(" ld a,l");
+	__asm__(" ld ($011B),a");
+	__asm__(" pop hl"); // C1
+	__asm__(" ld a,l");
+	__asm__(" ld ($011A),a");
+	__asm__(" pop hl"); // C0
+	__asm__(" ld a,l");
+	__asm__(" ld ($0119),a");
+	__asm__(" push bc");
+	__asm__(" call _dai_vpalette"); // palette index of colors for native functions
+	__asm__(" ld hl,$0119");
+	__asm__(" rst 5");
+	__asm__(" defb $1B"); // call $E6A4 in ROM
+	__asm__(" ret");
+}
@@ -0,0 +1,48 @@
+//====================================================================================
+// libdai : dai_colort
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_colort 
+// -----------------------------------------------------------------------------------
+// Change text colors (equivalent of colort)
+// Input : color 0,1,2,3 (from 0 to 15)
+// Registers are saved
+// Uses Dai ROM related function
+// -----------------------------------------------------------------------------------
+void dai_colort(uint8_t C0,uint8_t C1,uint8_t C2,uint8_t C3) {
+	__asm__(" push af");
+	__asm__(" push hl");
+	__asm__(" push de");
+	__asm__(" xor a");
+	__asm__(" ld (_dai_tok),a"); // color byte of dai_puts to be read again
+	__asm__(" ld (_dai_ttried),a");
+	__asm__(" ld hl,$0008");	
+	__asm__(" add hl,sp"); 
+	__asm__(" ld de,$011C");
+	__asm__(" ld a,(hl)"); // C3, Color 0-15
+	__asm__(" ld (de),a"); 
+	__asm__(" dec de");
+	__asm__(" inc hl");
+	__asm__(" inc hl");
+	__asm__(" ld a,(hl)"); // C2, Color 0-15
+	__asm__(" ld (de),a");
+	__asm__(" dec de");
+	__asm__(" inc hl");
+	__asm__(" inc hl");
+	__asm__(" ld a,(hl)"); // C1, Color 0-15
+	__asm__(" ld (de),a");
+	__asm__(" dec de");
+	__asm__(" inc hl");
+	__asm__(" inc hl");
+	__asm__(" ld a,(hl)"); // C0, Color 0-15
+	__asm__(" ld (de),a");
+	__asm__(" ld hl,$0119");
+	__asm__(" rst 5");
+	__asm__(" defb $06"); // call $E237 in ROM, input color vectors (coding 0-15) pointer in hl
+	__asm__(" pop de");
+	__asm__(" pop hl");
+	__asm__(" pop af");
+}
@@ -0,0 +1,33 @@
+//====================================================================================
+// libdai : dai_colort_callee
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_colort_callee
+// -----------------------------------------------------------------------------------
+// Same as dai_colort
+void dai_colort_callee(uint8_t C0,uint8_t C1,uint8_t C2,uint8_t C3) __z88dk_callee {
+	__asm__(" xor a");
+	__asm__(" ld (_dai_tok),a"); // color byte of dai_puts to be read again
+	__asm__(" ld (_dai_ttried),a");
+	__asm__(" pop bc"); // return address
+	__asm__(" pop hl"); // C3, Color 0-15
+	__asm__(" ld a,l");
+	__asm__(" ld ($011C),a");
+	__asm__(" pop hl"); // C2
+	__asm__(" ld a,l");
+	__asm__(" ld ($011B),a");
+	__asm__(" pop hl"); // C1
+	__asm__(" ld a,l");
+	__asm__(" ld ($011A),a");
+	__asm__(" pop hl"); // C0
+	__asm__(" ld a,l");
+	__asm__(" ld ($0119),a");
+	__asm__(" push bc");
+	__asm__(" ld hl,$0119");
+	__asm__(" rst 5");
+	__asm__(" defb $06"); // call $E237 in ROM
+	__asm__(" ret");
+}
@@ -0,0 +1,30 @@
+//====================================================================================
+// libdai : dai_cursor
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_cursor 
+// -----------------------------------------------------------------------------------
+// Set position of cursor. 0,0 = bottom left
+// Input : x, y 
+// Registers are saved
+// Uses Dai ROM related function
+void dai_cursor(uint8_t x, uint8_t y)
+{
+	__asm__(" push af");
+	__asm__(" push hl");
+	__asm__(" ld hl,$0006");	
+	__asm__(" add hl,sp"); 
+	__asm__(" ld a, (hl)"); // y in a
+	__asm__(" inc hl");
+	__asm__(" inc hl");
+	__asm__(" ld l,(hl)"); // x in l
+	__asm__(" ld h,a"); // y in h
+	// Input for Dai functions: h = y, l = x
+	__asm__(" rst 5");
+	__asm__(" defb $09"); // call $E279 in ROM
+	__asm__(" pop hl");
+	__asm__(" pop af");
+}
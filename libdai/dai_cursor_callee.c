@@ -0,0 +1,20 @@
+//====================================================================================
+// libdai : dai_cursor_callee
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_cursor_callee
+// -----------------------------------------------------------------------------------
+// Same as dai_cursor
+void dai_cursor_callee(uint8_t x, uint8_t y) __z88dk_callee {
+	__asm__(" pop de"); // return address
+	__asm__(" pop bc"); // y in h
+	__asm__(" pop hl"); // x in l
+	__asm__(" ld h,c");
+	__asm__(" push de");
+	__asm__(" rst 5");
+	__asm__(" defb $09"); // call $E279 in ROM
+	__asm__(" ret");
+}
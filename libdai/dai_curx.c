@@ -0,0 +1,21 @@
+//====================================================================================
+// libdai : dai_curx
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_curx 
+// -----------------------------------------------------------------------------------
+// get x position of cursor. 0,0 bottom left
+// Registers are saved except hl used for result
+// Uses Dai ROM related function
+// return in l
+uint8_t dai_curx(void)
+{
+	__asm__(" push de");
+	__asm__(" rst 5");
+	__asm__(" defb $0C"); // call $E2CC in ROM, return h=y, l=x, d=ymax, e=xmax
+	__asm__(" ld h,$00"); // x in l
+	__asm__(" pop de");
+}
@@ -0,0 +1,22 @@
+//====================================================================================
+// libdai : dai_cury
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_cury
+// -----------------------------------------------------------------------------------
+// get y position of cursor = 0,0 bottom left
+// Registers are saved except hl used for result
+// Uses Dai ROM related function
+// return in l
+uint8_t dai_cury(void)
+{
+	__asm__(" push de");
+	__asm__(" rst 5");
+	__asm__(" defb $0C"); // call $E2CC in ROM, return h=y, l=x, d=ymax, e=xmax
+	__asm__(" ld l,h"); 
+	__asm__(" ld h,$00"); // y in l
+	__asm__(" pop de");
+}
@@ -0,0 +1,38 @@
+//====================================================================================
+// libdai : dai_dot
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_dot 
+// -----------------------------------------------------------------------------------
+// Draw a dot using color reference set by Colorg
+// Default avaialble colors on reset are 0, 5, 10, 15
+// Input : x, y, color
+// Registers are saved
+// Uses Dai ROM related function
+// -----------------------------------------------------------------------------------
+void dai_dot(uint16_t x, uint8_t y, uint8_t c){
+	__asm__(" push af");
+	__asm__(" push hl");
+	__asm__(" push bc");
+	__asm__(" ld hl,$0008");	
+	__asm__(" add hl,sp"); 
+	__asm__(" ld a, (hl)"); // color in a
+	__asm__(" inc hl");
+	__asm__(" inc hl");
+	__asm__(" ld c,(hl)"); // y in c
+	__asm__(" inc hl");
+	__asm__(" inc hl");
+	__asm__(" ld b,(hl)"); // x in hl
+	__asm__(" inc hl");
+	__asm__(" ld h,(hl)");
+	__asm__(" ld l, b");		
+	// Input for Dai functions: x = HL, y = C, A : Color
+	__asm__(" rst 5");
+	__asm__(" defb $1E"); // call $E710 in ROM, input color vectors (coding 0-15) pointer in hl
+	__asm__(" pop bc");
+	__asm__(" pop hl");
+	__asm__(" pop af");
+}
@@ -0,0 +1,21 @@
+//====================================================================================
+// libdai : dai_dot_callee
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_dot_callee
+// -----------------------------------------------------------------------------------
+// Same as dai_dot
+void dai_dot_callee(uint16_t x, uint8_t y, uint8_t c) __z88dk_callee {
+	__asm__(" pop de"); // return address
+	__asm__(" pop hl"); // color in a
+	__asm__(" ld a,l");
+	__asm__(" pop bc"); // y in c
+	__asm__(" pop hl"); // x in hl
+	__asm__(" push de");
+	__asm__(" rst 5");
+	__asm__(" defb $1E"); // call $E710 in ROM
+	__asm__(" ret");
+}
@@ -0,0 +1,38 @@
+//====================================================================================
+// libdai : dai_dots
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_dots 
+// -----------------------------------------------------------------------------------
+// Plot n dots of row y from x to x+n-1, same result as n calls to dai_dot
+// Row address and first dot position are computed once for the whole row (4 colors modes)
+// 16 colors modes, dots out of screen and colors not in palette use dai_vdot
+// Input : x, y, n, buf = colors of the n dots
+void dai_dots(uint16_t x, uint8_t y, uint16_t n, uint8_t *buf)
+{
+	static uint16_t r;
+
+	if (n == 0) return;
+	if (dai_vok & (dai_v16 == 0) & (y <= dai_vymax) & (x + n - 1 >= x) & (x + n - 1 <= dai_vxmax)) {
+		if (dai_vrow[y][1] & 0x40) { // not a unit color line
+#ifdef DAI_BACKBUFFER
+			if (dai_bbact) dai_bbdirty(x, y, x + n - 1, y);
+#endif
+			while (n != 0) {
+				r = dai_vspan4(dai_vrow[y], x, n, buf);
+				if (r == 0) return;
+				x += n - r; // stopped on a color not in palette
+				buf += n - r;
+				dai_vdot(x, y, *buf);
+				x++;
+				buf++;
+				n = r - 1;
+			}
+			return;
+		}
+	}
+	for ( ; n != 0; n--) dai_vdot(x++, y, *buf++);
+}
@@ -0,0 +1,48 @@
+//====================================================================================
+// libdai : dai_draw
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_draw 
+// -----------------------------------------------------------------------------------
+// Draw a dot using color reference set by Colorg
+// Input : x0, y0, x1, y1, color
+// Registers are saved
+// Uses Dai ROM related function
+// -----------------------------------------------------------------------------------
+void dai_draw(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint8_t c) {
+	__asm__(" push af");
+	__asm__(" push hl");
+	__asm__(" push bc");	
+	__asm__(" push de");	
+	__asm__(" ld hl,$000A");	
+	__asm__(" add hl,sp"); 
+	__asm__(" ld a, (hl)"); // color in a
+	__asm__(" inc hl");
+	__asm__(" inc hl");
+	__asm__(" ld b,(hl)"); // y1 in b
+	__asm__(" inc hl");
+	__asm__(" inc hl");
+	__asm__(" ld e,(hl)"); // x1 in de
+	__asm__(" inc hl");
+	__asm__(" ld d,(hl)"); 
+	__asm__(" inc hl");
+	__asm__(" ld c,(hl)"); // y0 in c
+	__asm__(" push bc");
+	__asm__(" inc hl");
+	__asm__(" inc hl");
+	__asm__(" ld b,(hl)"); // x0 in hl via b
+	__asm__(" inc hl");
+	__asm__(" ld h,(hl)");
+	__asm__(" ld l, b");		
+	__asm__(" pop bc");
+	// Input for Dai functions: x0 = HL, x1 = DE, y0 = C, y1 = B, A = Color
+	__asm__(" rst 5");
+	__asm__(" defb $21");
+	__asm__(" pop de");	
+	__asm__(" pop bc");
+	__asm__(" pop hl");
+	__asm__(" pop af");
+}
@@ -0,0 +1,25 @@
+//====================================================================================
+// libdai : dai_draw_callee
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_draw_callee
+// -----------------------------------------------------------------------------------
+// Same as dai_draw
+void dai_draw_callee(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint8_t c) __z88dk_callee {
+	__asm__(" pop hl"); // return address
+	__asm__(" pop de"); // color in a
+	__asm__(" ld a,e");
+	__asm__(" pop bc"); // y1 in b
+	__asm__(" ld b,c");
+	__asm__(" pop de"); // x1 in de
+	__asm__(" ex (sp),hl"); // y0 in c, return address on stack
+	__asm__(" ld c,l");
+	__asm__(" pop hl");
+	__asm__(" ex (sp),hl"); // x0 in hl, return address on stack
+	__asm__(" rst 5");
+	__asm__(" defb $21");
+	__asm__(" ret");
+}
@@ -0,0 +1,16 @@
+//====================================================================================
+// libdai : dai_ellipse
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_ellipse 
+// -----------------------------------------------------------------------------------
+// Draw an ellipse, outline of dai_vellipse
+// Dots out of screen are not drawn
+// Input : center xc, yc, radii rx, ry (rx * ry at most 40000), color
+void dai_ellipse(uint16_t xc, uint8_t yc, uint8_t rx, uint8_t ry, uint8_t c)
+{
+	dai_vellipse(xc, yc, rx, ry, 0, c);
+}
@@ -0,0 +1,16 @@
+//====================================================================================
+// libdai : dai_ellipsefill
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_ellipsefill 
+// -----------------------------------------------------------------------------------
+// Draw a filled ellipse, dai_vellipse with one span per row
+// Dots out of screen are not drawn
+// Input : center xc, yc, radii rx, ry (rx * ry at most 40000), color
+void dai_ellipsefill(uint16_t xc, uint8_t yc, uint8_t rx, uint8_t ry, uint8_t c)
+{
+	dai_vellipse(xc, yc, rx, ry, 1, c);
+}
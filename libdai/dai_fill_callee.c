@@ -0,0 +1,25 @@
+//====================================================================================
+// libdai : dai_fill_callee
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_fill_callee
+// -----------------------------------------------------------------------------------
+// Same as dai_fill
+void dai_fill_callee(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint8_t c) __z88dk_callee {
+	__asm__(" pop hl"); // return address
+	__asm__(" pop de"); // color in a
+	__asm__(" ld a,e");
+	__asm__(" pop bc"); // y1 in b
+	__asm__(" ld b,c");
+	__asm__(" pop de"); // x1 in de
+	__asm__(" ex (sp),hl"); // y0 in c, return address on stack
+	__asm__(" ld c,l");
+	__asm__(" pop hl");
+	__asm__(" ex (sp),hl"); // x0 in hl, return address on stack
+	__asm__(" rst 5");
+	__asm__(" defb $24"); // call $E818 in ROM
+	__asm__(" ret");
+}
@@ -0,0 +1,90 @@
+//====================================================================================
+// libdai : dai_fill_polygon
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_fill_polygon 
+// -----------------------------------------------------------------------------------
+// Draw a filled polygon, even-odd rule (any shape, self-intersecting ones have holes)
+// Edge table : edges which are not horizontal, from their lower to their upper end, sorted
+// by lower row. Rows are scanned upward with an active edge list sorted by x : edges enter
+// at their lower row and leave at their upper row (so a vertex shared by two edges counts
+// once), their x is stepped with integers (quotient and remainder of the slope).
+// Each pair of active edges gives one span written with dai_vfill, then the edges are
+// drawn with dai_vdraw so that the outline is part of the polygon, as with dai_fill
+// Input : number of vertices n (3 to DAI_PEDGES), coordinates of vertices x[], y[] (on
+// screen), color
+// return 1 if done, 0 if not possible (number of vertices, vertex out of screen)
+uint8_t dai_fill_polygon(uint8_t n, uint16_t *x, uint8_t *y, uint8_t c)
+{
+	static int16_t ex[DAI_PEDGES], eq[DAI_PEDGES], er[DAI_PEDGES], ee[DAI_PEDGES], edy[DAI_PEDGES]; // x, slope and error of each edge
+	static uint8_t ey0[DAI_PEDGES], ey1[DAI_PEDGES]; // lower and upper rows of each edge
+	static uint8_t et[DAI_PEDGES], ael[DAI_PEDGES]; // edge table, active edge list
+	static uint8_t i, j, a, b, ne, na, next, row, top;
+	static int16_t dx;
+
+	if ((n < 3) | (n > DAI_PEDGES) | (dai_vmode == 0xFF)) return 0;
+	for (i = 0; i < n; i++) if ((x[i] > dai_vxmax) | (y[i] > dai_vymax)) return 0;
+
+	// Edge table
+	ne = 0;
+	top = 0;
+	for (i = 0; i < n; i++) {
+		a = i;
+		b = (i + 1 == n ? 0 : i + 1);
+		if (y[a] == y[b]) continue; // horizontal : outline only
+		if (y[a] > y[b]) {
+			a = b;
+			b = i;
+		}
+		ey0[ne] = y[a];
+		ey1[ne] = y[b];
+		if (y[b] > top) top = y[b];
+		edy[ne] = y[b] - y[a];
+		dx = (int16_t)x[b] - (int16_t)x[a];
+		eq[ne] = dx / edy[ne]; // floor of dx / dy, remainder between 0 and dy - 1
+		er[ne] = dx % edy[ne];
+		if (er[ne] < 0) {
+			eq[ne]--;
+			er[ne] += edy[ne];
+		}
+		ex[ne] = x[a];
+		ee[ne] = 0;
+		for (j = ne; (j != 0) && (ey0[et[j - 1]] > y[a]); j--) et[j] = et[j - 1];
+		et[j] = ne;
+		ne++;
+	}
+
+	// Rows from the lowest vertex, spans between pairs of active edges
+	na = 0;
+	next = 0;
+	for (row = (ne ? ey0[et[0]] : top); row < top; row++) {
+		for (i = 0, j = 0; i < na; i++) if (ey1[ael[i]] != row) ael[j++] = ael[i]; // leaving edges
+		na = j;
+		while ((next < ne) && (ey0[et[next]] == row)) ael[na++] = et[next++]; // entering edges
+		for (i = 1; i < na; i++) { // sort by x, the list is almost sorted
+			a = ael[i];
+			for (j = i; (j != 0) && (ex[ael[j - 1]] > ex[a]); j--) ael[j] = ael[j - 1];
+			ael[j] = a;
+		}
+		for (i = 0; i + 1 < na; i += 2) dai_vfill(ex[ael[i]], row, ex[ael[i + 1]], row, c);
+		for (i = 0; i < na; i++) {
+			a = ael[i];
+			ex[a] += eq[a];
+			ee[a] += er[a];
+			if (ee[a] >= edy[a]) {
+				ex[a]++;
+				ee[a] -= edy[a];
+			}
+		}
+	}
+
+	// Outline
+	for (i = 0; i < n; i++) {
+		b = (i + 1 == n ? 0 : i + 1);
+		dai_vdraw(x[i], y[i], x[b], y[b], c);
+	}
+	return 1;
+}
@@ -0,0 +1,82 @@
+//====================================================================================
+// libdai : dai_flood_fill
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_flood_fill 
+// -----------------------------------------------------------------------------------
+// Fill with color c the area of dots of the color of x,y connected to it (4 neighbors)
+// Span fill without recursion : a seed is popped from a stack in buf, its row is scanned
+// left and right with dai_vscrn (same result as dai_scrn) while the dots keep the old
+// color, the whole span is written with dai_vfill, then one seed is pushed for each run
+// of dots of the old color in the row below and in the row above the span
+// A seed takes 3 bytes (x, y), a few hundred bytes are enough for usual shapes. When the
+// stack is full seeds are dropped and the area may be partly filled
+// Input : x, y, color, buf and size of buf in bytes (at least 3)
+// return 1 if done, 0 if not possible or partly done (text mode, dot out of screen, full
+// stack, color which can not be set in a 16 colors block)
+uint8_t dai_flood_fill(uint16_t x, uint8_t y, uint8_t c, uint8_t *buf, uint16_t size)
+{
+	static uint16_t xl, xr, i, sp, top;
+	static uint8_t old, ok, run, d, r;
+
+	if ((dai_vmode == 0xFF) | (x > dai_vxmax) | (y > dai_vymax) | (size < 3)) return 0;
+	old = dai_vscrn(x, y);
+	if (old == c) return 1;
+	top = size - size % 3;
+	buf[0] = x;
+	buf[1] = x >> 8;
+	buf[2] = y;
+	sp = 3;
+	ok = 1;
+	while (sp != 0) {
+		sp -= 3;
+		x = buf[sp] | (buf[sp + 1] << 8);
+		y = buf[sp + 2];
+		if (dai_vscrn(x, y) != old) continue; // filled since pushed
+		xl = x;
+		while ((xl != 0) && (dai_vscrn(xl - 1, y) == old)) xl--;
+		xr = x;
+		while ((xr != dai_vxmax) && (dai_vscrn(xr + 1, y) == old)) xr++;
+		dai_vfill(xl, y, xr, y, c);
+		if (dai_vscrn(x, y) == old) return 0; // not changed, would not end
+
+		// Rows below and above : seed at the last dot of each run
+		for (d = 0; d < 2; d++) {
+			if (d == 0) {
+				if (y == 0) continue;
+				r = y - 1;
+			} else {
+				if (y == dai_vymax) continue;
+				r = y + 1;
+			}
+			run = 0;
+			for (i = xl; ; i++) {
+				if (dai_vscrn(i, r) == old) run = 1;
+				else if (run) {
+					run = 0;
+					if (sp == top) ok = 0;
+					else {
+						buf[sp] = i - 1;
+						buf[sp + 1] = (i - 1) >> 8;
+						buf[sp + 2] = r;
+						sp += 3;
+					}
+				}
+				if (i == xr) break;
+			}
+			if (run) {
+				if (sp == top) ok = 0;
+				else {
+					buf[sp] = xr;
+					buf[sp + 1] = xr >> 8;
+					buf[sp + 2] = r;
+					sp += 3;
+				}
+			}
+		}
+	}
+	return ok;
+}
@@ -0,0 +1,43 @@
+//====================================================================================
+// libdai : dai_mode
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_mode : Change graphic modes
+// -----------------------------------------------------------------------------------
+// Graphic mode (*A = graphic area with 4 text lines of 60 characters)
+// Input :  
+// 0xFF = text, 24 lines, 60 characters
+// 0  = mode 1, 1  = mode 1A, 72x65, 16 colors
+// 2  = mode 2, 3  = mode 2A, 72x65, 4 colors
+// 4  = mode 3, 5  = mode 3A, 160x130, 16 colors
+// 6  = mode 4, 7  = mode 4A, 160x130, 4 colors
+// 8  = mode 5, 9  = mode 5A, 336x256, 16 colors
+// 10 = mode 6, 11 = mode 6A, 336x256, 4 colors
+// Registers are saved
+// Uses Dai ROM related function, then dai_vinit for the graphics context of native screen functions
+// -----------------------------------------------------------------------------------
+void dai_mode(uint8_t m) {
+	__asm__(" push af");
+	__asm__(" push hl");
+	__asm__(" ld hl,$0006");	
+	__asm__(" add hl,sp"); 
+	__asm__(" ld a,(hl)");
+	__asm__(" rst 5");
+	__asm__(" defb $18"); // call $E3D9 in ROM
+	__asm__(" push bc");
+	__asm__(" push de");
+	__asm__(" ld hl,$000A");	
+	__asm__(" add hl,sp"); 
+	__asm__(" ld l,(hl)"); // m as argument of dai_vinit
+	__asm__(" ld h,$00");
+	__asm__(" push hl");
+	__asm__(" call _dai_vinit");
+	__asm__(" pop hl");
+	__asm__(" pop de");
+	__asm__(" pop bc");
+	__asm__(" pop hl");
+	__asm__(" pop af");
+}
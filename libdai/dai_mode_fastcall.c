@@ -0,0 +1,18 @@
+//====================================================================================
+// libdai : dai_mode_fastcall
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_mode_fastcall
+// -----------------------------------------------------------------------------------
+// Same as dai_mode, m in l
+void dai_mode_fastcall(uint8_t m) __z88dk_fastcall {
+	__asm__(" push hl"); // m as argument of dai_vinit
+	__asm__(" ld a,l");
+	__asm__(" rst 5");
+	__asm__(" defb $18"); // call $E3D9 in ROM
+	__asm__(" call _dai_vinit");
+	__asm__(" pop hl");
+}
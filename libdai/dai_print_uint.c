@@ -0,0 +1,24 @@
+//====================================================================================
+// libdai : dai_print_uint
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_print_uint
+// -----------------------------------------------------------------------------------
+// Print v in decimal at cursor position with dai_puts
+// Registers are not saved
+void dai_print_uint(uint16_t v)
+{
+	static char buf[6];
+	static uint8_t i;
+
+	i = 5;
+	buf[5] = 0;
+	do {
+		buf[--i] = '0' + v % 10;
+		v /= 10;
+	} while (v != 0);
+	dai_puts(&buf[i]);
+}
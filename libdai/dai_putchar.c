@@ -0,0 +1,25 @@
+//====================================================================================
+// libdai : dai_putchar
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_putchar 
+// -----------------------------------------------------------------------------------
+// Print character c at cursor position, control characters are processed by the ROM
+// (ex: 0x0D new line, 0x0C clear screen), the screen scrolls when needed
+// Registers are saved
+// Uses Dai ROM related function
+void dai_putchar(uint8_t c)
+{
+	__asm__(" push af"); 
+	__asm__(" push hl");
+	__asm__(" ld hl,$0006");	
+	__asm__(" add hl,sp"); 
+	__asm__(" ld a,(hl)"); // c
+	__asm__(" rst 5"); // call $E102 in ROM
+	__asm__(" defb $03");
+	__asm__(" pop hl");
+	__asm__(" pop af"); 
+}
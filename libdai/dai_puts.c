@@ -0,0 +1,41 @@
+//====================================================================================
+// libdai : dai_puts
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_puts
+// -----------------------------------------------------------------------------------
+// Print a string at cursor position, same result as printing each character with the ROM
+// Printable characters up to the column before last are written in screen memory, the
+// cursor is moved by the ROM before they are written (the ROM restores the cell it leaves)
+// Registers are not saved
+void dai_puts(char *str)
+{
+	static uint8_t *p;
+	static uint8_t x, y, n, i;
+
+	if (!dai_ttried) dai_tinit(); // once, ROM output if it failed
+	while (*str) {
+		if (!dai_tok | ((uint8_t)*str < 0x20)) {
+			dai_putchar(*str++);
+			continue;
+		}
+		x = dai_curx();
+		y = dai_cury();
+		for (n = 0; ((uint8_t)str[n] >= 0x20) & (x + n < dai_txmax); n++);
+		if ((n == 0) | (y >= dai_tn)) {
+			dai_putchar(*str++); // last column, the ROM goes to next line
+			continue;
+		}
+		dai_cursor(x + n, y);
+		p = dai_trow[y] + x * dai_tstep;
+		for (i = 0; i < n; i++) {
+			*p = str[i];
+			if (dai_tattr) *(p + dai_tattr) = dai_tcolor;
+			p += dai_tstep;
+		}
+		str += n;
+	}
+}
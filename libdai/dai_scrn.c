@@ -0,0 +1,36 @@
+//====================================================================================
+// libdai : dai_scrn
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_scrn 
+// -----------------------------------------------------------------------------------
+// Get color of dot. 0,0 bottom left
+// Input : x, y
+// Registers are saved except hl used for result
+// Uses Dai ROM related function
+uint8_t dai_scrn(uint16_t x, uint8_t y)
+{
+	__asm__(" push af");
+	__asm__(" push bc");
+	__asm__(" push de");
+	__asm__(" ld hl,$0008");	
+	__asm__(" add hl,sp"); 
+	__asm__(" ld c, (hl)"); // y in c
+	__asm__(" inc hl");
+	__asm__(" inc hl");
+	__asm__(" ld a,(hl)"); // x in hl
+	__asm__(" inc hl");
+	__asm__(" ld h,(hl)"); 
+	__asm__(" ld l,a"); 
+	// Input for Dai functions: x = hl, y = c
+	__asm__(" rst 5");
+	__asm__(" defb $27"); // call $E884 in ROM, return a=color, b=ymax, de=xmax
+	__asm__(" ld h,$00"); // color in hl
+	__asm__(" ld l,a"); 
+	__asm__(" pop de");
+	__asm__(" pop bc");
+	__asm__(" pop af");
+}
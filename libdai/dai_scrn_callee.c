@@ -0,0 +1,21 @@
+//====================================================================================
+// libdai : dai_scrn_callee
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_scrn_callee
+// -----------------------------------------------------------------------------------
+// Same as dai_scrn
+// return in hl
+uint8_t dai_scrn_callee(uint16_t x, uint8_t y) __z88dk_callee {
+	__asm__(" pop hl"); // return address
+	__asm__(" pop bc"); // y in c
+	__asm__(" ex (sp),hl"); // x in hl, return address on stack
+	__asm__(" rst 5");
+	__asm__(" defb $27"); // call $E884 in ROM, return a=color, b=ymax, de=xmax
+	__asm__(" ld h,$00"); // color in hl
+	__asm__(" ld l,a"); 
+	__asm__(" ret");
+}
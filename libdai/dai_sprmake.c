@@ -0,0 +1,49 @@
+//====================================================================================
+// libdai : dai_sprmake
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_sprmake 
+// -----------------------------------------------------------------------------------
+// Make a sprite for dai_blit from a color buffer : 8 copies shifted by 0 to 7 dots, so
+// that dai_blit writes whole pairs without any shift whatever x is
+// Layout : w, h, pairs of a row (DAI_SPRCOLS(w)), then for each shift s (x & 7 of dai_blit)
+// h rows from the top, for each pair of a row 3 bytes : mask of the dots of the sprite,
+// bits of the first byte, bits of the second byte (palette index bits 0 and 1)
+// The palette indexes are the ones of the colors set by dai_colorg when it is called
+// Input : spr = buffer of DAI_SPRSIZE(w, h) bytes, w and h (1 to 255), dots = w * h colors
+// row by row from the top, 0xFF for a transparent dot
+// return 1 if done, 0 if a color is not in the palette
+uint8_t dai_sprmake(uint8_t *spr, uint8_t w, uint8_t h, uint8_t *dots)
+{
+	static uint8_t *q, *d;
+	static uint16_t i, n;
+	static uint8_t s, r, k, cols, idx, mk;
+
+	n = w * h;
+	for (i = 0; i < n; i++) if ((dots[i] != 0xFF) & ((dots[i] > 15) || (dai_vidx[dots[i] & 0x0F] == 0xFF))) return 0;
+	cols = DAI_SPRCOLS(w);
+	spr[0] = w;
+	spr[1] = h;
+	spr[2] = cols;
+	q = spr + 3;
+	for (s = 0; s < 8; s++) {
+		d = dots;
+		for (r = 0; r < h; r++) {
+			for (k = 0; k < 3 * cols; k++) q[k] = 0;
+			for (i = 0; i < w; i++, d++) {
+				if (*d == 0xFF) continue;
+				k = 3 * ((i + s) >> 3);
+				mk = dai_vmask[(i + s) & 7];
+				idx = dai_vidx[*d];
+				q[k] |= mk;
+				if (idx & 1) q[k + 1] |= mk;
+				if (idx & 2) q[k + 2] |= mk;
+			}
+			q += 3 * cols;
+		}
+	}
+	return 1;
+}
@@ -0,0 +1,21 @@
+//====================================================================================
+// libdai : dai_textmax
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_textmax
+// -----------------------------------------------------------------------------------
+// get max positions of cursor in current mode
+// Registers are saved except hl used for result
+// Uses Dai ROM related function
+// return ymax in h, xmax in l
+uint16_t dai_textmax(void)
+{
+	__asm__(" push de");
+	__asm__(" rst 5");
+	__asm__(" defb $0C"); // call $E2CC in ROM, return h=y, l=x, d=ymax, e=xmax
+	__asm__(" ex de,hl"); // ymax in h, xmax in l
+	__asm__(" pop de");
+}
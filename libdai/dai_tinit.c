@@ -0,0 +1,72 @@
+//====================================================================================
+// libdai : dai_tinit
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_tinit
+// -----------------------------------------------------------------------------------
+// Build dai_trow and the layout of characters for the current mode and text colors
+// Sets dai_tok to 1 if successful, text is then written in screen memory by dai_puts
+// Sets dai_ttried : dai_puts does not try again before the next dai_vinit or dai_colort
+// Registers are not saved
+void dai_tinit(void)
+{
+	static uint8_t *a, *line[DAI_TLINES], *r;
+	static uint8_t save[132]; // bytes of 66 pairs, widest line
+	static uint8_t mk[4] = {'J', 'Q', '#', '%'}; // characters printed by the ROM, two tries
+	static uint16_t s, t;
+	static uint8_t n, mb, cx, cy, i, i0, i1, k;
+
+	dai_tok = 0;
+	dai_ttried = 1;
+
+	// Collect text lines, top of screen first
+	a = DAI_ADDR(0xBFFF);
+	n = 0;
+	s = 0;
+	while ((s < DAI_VSCANS) & (n < DAI_TLINES)) {
+		mb = *a;
+		if (mb & 0x40) {
+			line[n] = a - 2;
+			n++;
+		}
+		s += ((mb & 0x0F) + 1) << 1;
+		a -= 2 + (dai_vpairs[(mb >> 4) & 0x03] << 1);
+	}
+	t = dai_textmax();
+	if ((n == 0) | (n != (t >> 8) + 1)) return;
+	dai_tn = n;
+	dai_txmax = t & 0xFF;
+
+	// Print two characters at column 0 of the cursor line, find them, restore the line
+	cx = dai_curx();
+	cy = dai_cury();
+	r = line[n - 1 - cy];
+	for (k = 0; k < 4; k += 2) {
+		for (i = 0; i < 132; i++) save[i] = *(r - i);
+		dai_cursor(0, cy);
+		dai_putchar(mk[k]);
+		dai_putchar(mk[k + 1]);
+		i0 = 0xFF;
+		i1 = 0xFF;
+		for (i = 0; i < 132; i++) {
+			if ((*(r - i) == mk[k]) & (save[i] != mk[k]) & (i0 == 0xFF)) i0 = i;
+			if ((*(r - i) == mk[k + 1]) & (save[i] != mk[k + 1]) & (i1 == 0xFF)) i1 = i;
+		}
+		if ((i0 != 0xFF) & (i1 != 0xFF)) {
+			dai_tstep = i0 - i1;
+			dai_tattr = (i1 - i0 == 1 ? 0 : ((i0 & 1) ? 1 : -1)); // color byte is the other byte of the pair
+			dai_tcolor = *(r - i0 + dai_tattr);
+			dai_tok = ((i1 - i0 == 1) | (i1 - i0 == 2));
+		}
+		for (i = 0; i < 132; i++) *(r - i) = save[i];
+		dai_cursor(cx, cy);
+		if (dai_tok) break;
+	}
+	if (!dai_tok) return;
+
+	// Column 0 of each line, line 0 at bottom
+	for (i = 0; i < n; i++) dai_trow[i] = line[n - 1 - i] - i0;
+}
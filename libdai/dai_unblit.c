@@ -0,0 +1,38 @@
+//====================================================================================
+// libdai : dai_unblit
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_unblit 
+// -----------------------------------------------------------------------------------
+// Put back what was under a sprite drawn by dai_blit with a save buffer
+// Each row is restored the way dai_blit saved it : pairs with dai_vcopy or dots with
+// dai_vdot. Moving a sprite : dai_unblit at the old place, then dai_blit at the new one
+// (in the back buffer, see dai_bbon, for a move without flicker)
+// Input : spr, x, y and save given to dai_blit, screen mode not changed since then
+void dai_unblit(uint8_t *spr, uint16_t x, uint8_t y, uint8_t *save)
+{
+	static uint8_t *sv;
+	static uint8_t w, h, cols, stride, r, row, i;
+
+	if ((dai_vmode == 0xFF) | (x > dai_vxmax)) return;
+	w = spr[0];
+	h = spr[1];
+	cols = spr[2];
+	stride = (w > 2 * cols ? w : 2 * cols) + 1;
+#ifdef DAI_BACKBUFFER
+	if (dai_bbact & (y <= dai_vymax)) dai_bbdirty(x, (y >= h ? y - h + 1 : 0), (x + w - 1 <= dai_vxmax ? x + w - 1 : dai_vxmax), y);
+#endif
+	sv = save;
+	row = y;
+	for (r = 0; r < h; r++, row--) {
+		if (row <= dai_vymax) {
+			if (sv[0]) dai_vcopy(dai_vrow[row] - (((x + 8) >> 3) << 1), sv + 2 * cols, 2 * cols);
+			else for (i = 0; (i < w) && (x + i <= dai_vxmax); i++) dai_vdot(x + i, row, sv[i + 1]);
+		}
+		if (row == 0) break;
+		sv += stride;
+	}
+}
@@ -0,0 +1,48 @@
+//====================================================================================
+// libdai : global variables (graphics context, text and back buffer state)
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// Graphics context : native screen state, set by dai_vinit (called by dai_mode) and
+// dai_vpalette (called by dai_colorg), read by dai_xmax, dai_ymax and native functions
+// -----------------------------------------------------------------------------------
+uint8_t dai_vmode = 0xFF; // Graphic mode set by dai_mode, 0xFF for text or not set
+uint8_t dai_vok = 0; // 1 when native functions can write in screen memory
+uint8_t dai_v16; // 1 for 16 colors modes, 0 for 4 colors modes
+uint8_t dai_vhi; // 16 colors modes : 1 when dots set in pattern byte use high nibble of color byte
+uint16_t dai_vxmax; // xmax of current graphic mode
+uint8_t dai_vymax; // ymax of current graphic mode
+uint8_t *dai_vrow[DAI_VLINES]; // Address of first data byte of each row, row 0 at bottom
+uint8_t *dai_vlow; // Lowest address of screen memory (last byte of the bottom line)
+uint8_t dai_vmask[8] = {0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01}; // Bit of each dot in a byte
+uint8_t dai_vpairs[4] = {11, 22, 44, 66}; // Data byte pairs of a line for each resolution
+uint8_t dai_palette[4] = {0, 5, 10, 15}; // Colors set by dai_colorg (reset values)
+uint8_t dai_vidx[16] = {0, 0xFF, 0xFF, 0xFF, 0xFF, 1, 0xFF, 0xFF, 0xFF, 0xFF, 2, 0xFF, 0xFF, 0xFF, 0xFF, 3}; // Palette index of each color, 0xFF if not in palette
+
+
+// -----------------------------------------------------------------------------------
+// Native text state, set by dai_tinit
+// -----------------------------------------------------------------------------------
+uint8_t dai_tok = 0; // 1 when dai_puts can write in screen memory, reset by dai_vinit and dai_colort
+uint8_t dai_ttried = 0; // 1 once dai_tinit has run, even if it failed, reset with dai_tok
+uint8_t dai_tn; // Number of text lines
+uint8_t dai_txmax; // Last column
+uint8_t *dai_trow[DAI_TLINES]; // Address of the character of column 0 of each text line, line 0 at bottom
+int8_t dai_tstep; // Address step from a column to the next one
+int8_t dai_tattr; // Offset of the color byte from the character byte, 0 if none
+uint8_t dai_tcolor; // Color byte written by the ROM with characters
+
+
+// -----------------------------------------------------------------------------------
+// Back buffer state, set by dai_bbon
+// -----------------------------------------------------------------------------------
+#ifdef DAI_BACKBUFFER
+
+uint8_t dai_bbact = 0; // 1 when dai_vrow points to the rows of the back buffer
+uint8_t *dai_bbscr[256]; // Screen rows while the back buffer is active
+uint8_t dai_bbn = 0; // Number of dirty rectangles
+uint16_t dai_bbx0[DAI_BBRECTS], dai_bbx1[DAI_BBRECTS]; // Dirty rectangles
+uint8_t dai_bby0[DAI_BBRECTS], dai_bby1[DAI_BBRECTS];
+#endif
@@ -0,0 +1,61 @@
+//====================================================================================
+// libdai : dai_vblit4
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vblit4 
+// -----------------------------------------------------------------------------------
+// Write n pairs of a row of a sprite made by dai_sprmake in a row of a 4 colors mode
+// For each pair the sprite gives 3 bytes : mask, bits of the first byte, bits of the
+// second byte (bits out of the mask are 0), first byte = (first byte & ~mask) | bits
+// Input : p = address of first byte of the first pair, s = first byte of the sprite row, n
+// No check on p and n
+// Registers are not saved
+// return in hl the address of the next row of the sprite
+uint8_t *dai_vblit4(uint8_t *p, uint8_t *s, uint8_t n)
+{
+	__asm__(" ld hl,$0002");	
+	__asm__(" add hl,sp"); 
+	__asm__(" ld b,(hl)"); // n in b
+	__asm__(" inc hl");
+	__asm__(" inc hl");
+	__asm__(" ld e,(hl)"); // s in de
+	__asm__(" inc hl");
+	__asm__(" ld d,(hl)");
+	__asm__(" inc hl");
+	__asm__(" ld a,(hl)"); // p in hl
+	__asm__(" inc hl");
+	__asm__(" ld h,(hl)");
+	__asm__(" ld l,a");
+	__asm__(" ld a,b");
+	__asm__(" or a");
+	__asm__(" jp z,dai_vblit4_end");
+	// hl = screen (downward), de = sprite, c = ~mask
+	__asm__("dai_vblit4_loop:");
+	__asm__(" ld a,(de)");
+	__asm__(" cpl");
+	__asm__(" ld c,a");
+	__asm__(" inc de");
+	__asm__(" ld a,(hl)"); // first byte
+	__asm__(" and c");
+	__asm__(" ex de,hl");
+	__asm__(" or (hl)");
+	__asm__(" inc hl");
+	__asm__(" ex de,hl");
+	__asm__(" ld (hl),a");
+	__asm__(" dec hl");
+	__asm__(" ld a,(hl)"); // second byte
+	__asm__(" and c");
+	__asm__(" ex de,hl");
+	__asm__(" or (hl)");
+	__asm__(" inc hl");
+	__asm__(" ex de,hl");
+	__asm__(" ld (hl),a");
+	__asm__(" dec hl");
+	__asm__(" dec b");
+	__asm__(" jp nz,dai_vblit4_loop");
+	__asm__("dai_vblit4_end:");
+	__asm__(" ex de,hl"); // next row of the sprite in hl
+}
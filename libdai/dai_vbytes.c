@@ -0,0 +1,52 @@
+//====================================================================================
+// libdai : dai_vbytes
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vbytes 
+// -----------------------------------------------------------------------------------
+// Write n whole pairs of a 4 colors mode with one color, 8 dots for each pair
+// Input : p = address of first byte of the first pair, n, pt0 and pt1 = pattern of the color
+// Registers are saved
+void dai_vbytes(uint8_t *p, uint16_t n, uint8_t pt0, uint8_t pt1)
+{
+	__asm__(" push af");
+	__asm__(" push hl");
+	__asm__(" push bc");
+	__asm__(" push de");
+	__asm__(" ld hl,$000A");	
+	__asm__(" add hl,sp"); 
+	__asm__(" ld e,(hl)"); // pt1 in e
+	__asm__(" inc hl");
+	__asm__(" inc hl");
+	__asm__(" ld d,(hl)"); // pt0 in d
+	__asm__(" inc hl");
+	__asm__(" inc hl");
+	__asm__(" ld c,(hl)"); // n in bc
+	__asm__(" inc hl");
+	__asm__(" ld b,(hl)");
+	__asm__(" inc hl");
+	__asm__(" ld a,(hl)"); // p in hl
+	__asm__(" inc hl");
+	__asm__(" ld h,(hl)");
+	__asm__(" ld l,a");
+	__asm__(" ld a,b");
+	__asm__(" or c");
+	__asm__(" jp z,dai_vbytes_end");
+	__asm__("dai_vbytes_loop:");
+	__asm__(" ld (hl),d");
+	__asm__(" dec hl");
+	__asm__(" ld (hl),e");
+	__asm__(" dec hl");
+	__asm__(" dec bc");
+	__asm__(" ld a,b");
+	__asm__(" or c");
+	__asm__(" jp nz,dai_vbytes_loop");
+	__asm__("dai_vbytes_end:");
+	__asm__(" pop de");
+	__asm__(" pop bc");
+	__asm__(" pop hl");
+	__asm__(" pop af");
+}
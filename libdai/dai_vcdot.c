@@ -0,0 +1,17 @@
+//====================================================================================
+// libdai : dai_vcdot
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vcdot 
+// -----------------------------------------------------------------------------------
+// Draw a dot with dai_vdot if it is on the screen, nothing otherwise
+// Used by the curves, whose dots may be out of screen on any side
+// Input : x, y (signed), color
+void dai_vcdot(int16_t x, int16_t y, uint8_t c)
+{
+	if ((x < 0) | (y < 0) | (x > (int16_t)dai_vxmax) | (y > (int16_t)dai_vymax)) return;
+	dai_vdot(x, y, c);
+}
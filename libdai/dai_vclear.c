@@ -0,0 +1,35 @@
+//====================================================================================
+// libdai : dai_vclear
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vclear 
+// -----------------------------------------------------------------------------------
+// Fill the whole graphic screen with a color, much faster than a new dai_mode
+// Width of graphic modes is a multiple of 8 dots : every row is written as whole pairs
+// 16 colors modes and colors not in palette use the ROM fill
+// Input : color
+void dai_vclear(uint8_t c)
+{
+	static uint16_t n;
+	static uint8_t y, idx, pt0, pt1;
+
+	idx = (c > 15 ? 0xFF : dai_vidx[c]);
+	if ((dai_vok == 0) | dai_v16 | (idx == 0xFF)) {
+		dai_fill(0, 0, dai_xmax(), dai_ymax(), c);
+		return;
+	}
+	pt0 = ((idx & 1) ? 0xFF : 0x00); // pattern of first and second bytes
+	pt1 = ((idx & 2) ? 0xFF : 0x00);
+	n = (dai_vxmax + 1) >> 3;
+#ifdef DAI_BACKBUFFER
+	if (dai_bbact) dai_bbdirty(0, 0, dai_vxmax, dai_vymax);
+#endif
+	for (y = 0; ; y++) {
+		if (dai_vrow[y][1] & 0x40) dai_vbytes(dai_vrow[y] - 2, n, pt0, pt1); // first pair after the unused one
+		else dai_fill(0, y, dai_vxmax, y, c); // unit color line
+		if (y == dai_vymax) break;
+	}
+}
@@ -0,0 +1,51 @@
+//====================================================================================
+// libdai : dai_vcopy
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vcopy 
+// -----------------------------------------------------------------------------------
+// Copy n bytes downward (screen memory order), dst and src are the highest addresses
+// Used by the back buffer and by the save-under buffers of dai_blit
+// Input : dst, src, n
+// Registers are saved
+void dai_vcopy(uint8_t *dst, uint8_t *src, uint16_t n)
+{
+	__asm__(" push af");
+	__asm__(" push hl");
+	__asm__(" push bc");
+	__asm__(" push de");
+	__asm__(" ld hl,$000A");	
+	__asm__(" add hl,sp"); 
+	__asm__(" ld c,(hl)"); // n in bc
+	__asm__(" inc hl");
+	__asm__(" ld b,(hl)");
+	__asm__(" inc hl");
+	__asm__(" ld e,(hl)"); // src in de
+	__asm__(" inc hl");
+	__asm__(" ld d,(hl)");
+	__asm__(" inc hl");
+	__asm__(" ld a,(hl)"); // dst in hl
+	__asm__(" inc hl");
+	__asm__(" ld h,(hl)");
+	__asm__(" ld l,a");
+	__asm__(" ld a,b");
+	__asm__(" or c");
+	__asm__(" jp z,dai_vcopy_end");
+	__asm__("dai_vcopy_loop:");
+	__asm__(" ld a,(de)");
+	__asm__(" ld (hl),a");
+	__asm__(" dec de");
+	__asm__(" dec hl");
+	__asm__(" dec bc");
+	__asm__(" ld a,b");
+	__asm__(" or c");
+	__asm__(" jp nz,dai_vcopy_loop");
+	__asm__("dai_vcopy_end:");
+	__asm__(" pop de");
+	__asm__(" pop bc");
+	__asm__(" pop hl");
+	__asm__(" pop af");
+}
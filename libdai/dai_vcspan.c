@@ -0,0 +1,19 @@
+//====================================================================================
+// libdai : dai_vcspan
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vcspan 
+// -----------------------------------------------------------------------------------
+// Draw dots x0 to x1 of row y with dai_vfill, clipped to the screen
+// Used by the filled curves : one span per row, written 8 dots at a time in 4 colors modes
+// Input : x0 <= x1, y (signed), color
+void dai_vcspan(int16_t x0, int16_t x1, int16_t y, uint8_t c)
+{
+	if ((y < 0) | (y > (int16_t)dai_vymax) | (x1 < 0) | (x0 > (int16_t)dai_vxmax)) return;
+	if (x0 < 0) x0 = 0;
+	if (x1 > (int16_t)dai_vxmax) x1 = dai_vxmax;
+	dai_vfill(x0, y, x1, y, c);
+}
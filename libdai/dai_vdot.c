@@ -0,0 +1,37 @@
+//====================================================================================
+// libdai : dai_vdot
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vdot 
+// -----------------------------------------------------------------------------------
+// Draw a dot directly in screen memory, same result as dai_dot
+// Input : x, y, color
+// Registers are saved
+// Uses Dai ROM related function when native access is not possible
+// -----------------------------------------------------------------------------------
+void dai_vdot(uint16_t x, uint8_t y, uint8_t c){
+	__asm__(" push af");
+	__asm__(" push hl");
+	__asm__(" push bc");
+	__asm__(" push de");
+	__asm__(" ld hl,$000A");	
+	__asm__(" add hl,sp"); 
+	__asm__(" ld a, (hl)"); // color in a
+	__asm__(" inc hl");
+	__asm__(" inc hl");
+	__asm__(" ld c,(hl)"); // y in c
+	__asm__(" inc hl");
+	__asm__(" inc hl");
+	__asm__(" ld e,(hl)"); // x in hl
+	__asm__(" inc hl");
+	__asm__(" ld d,(hl)");
+	__asm__(" ex de,hl");
+	__asm__(" call _dai_vdot_reg");
+	__asm__(" pop de");
+	__asm__(" pop bc");
+	__asm__(" pop hl");
+	__asm__(" pop af");
+}
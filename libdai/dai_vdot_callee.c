@@ -0,0 +1,20 @@
+//====================================================================================
+// libdai : dai_vdot_callee
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vdot_callee 
+// -----------------------------------------------------------------------------------
+// Same as dai_vdot, registers are not saved
+// -----------------------------------------------------------------------------------
+void dai_vdot_callee(uint16_t x, uint8_t y, uint8_t c) __z88dk_callee {
+	__asm__(" pop de"); // return address
+	__asm__(" pop hl"); // color in a
+	__asm__(" ld a,l");
+	__asm__(" pop bc"); // y in c
+	__asm__(" pop hl"); // x in hl
+	__asm__(" push de");
+	__asm__(" jp _dai_vdot_reg");
+}
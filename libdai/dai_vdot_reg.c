@@ -0,0 +1,191 @@
+//====================================================================================
+// libdai : dai_vdot_reg
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vdot_reg 
+// -----------------------------------------------------------------------------------
+// Core of dai_vdot and dai_vdot_callee, same registers interface as ROM dot routine
+// Input : hl = x, c = y, a = color
+// Modifies af, bc, de, hl
+// -----------------------------------------------------------------------------------
+void dai_vdot_reg(void){
+	__asm__(" push hl"); // x, y and color kept for ROM fallback
+	__asm__(" push bc");
+	__asm__(" push af");
+#ifdef DAI_BACKBUFFER
+	__asm__(" ld a,(_dai_bbact)");
+	__asm__(" or a");
+	__asm__(" call nz,dai_vdot_bb"); // dirty dot
+#endif
+	__asm__(" ld a,(_dai_vok)");
+	__asm__(" or a");
+	__asm__(" jp z,dai_vdot_rom");
+	__asm__(" ld a,(_dai_vymax)"); // y <= ymax
+	__asm__(" cp c");
+	__asm__(" jp c,dai_vdot_rom");
+	__asm__(" ex de,hl"); // x in de
+	__asm__(" ld hl,(_dai_vxmax)"); // x <= xmax
+	__asm__(" ld a,l");
+	__asm__(" sub e");
+	__asm__(" ld a,h");
+	__asm__(" sbc a,d");
+	__asm__(" jp c,dai_vdot_rom");
+	__asm__(" ld b,$00"); // row address in hl
+	__asm__(" ld hl,_dai_vrow");
+	__asm__(" add hl,bc");
+	__asm__(" add hl,bc");
+	__asm__(" ld a,(hl)");
+	__asm__(" inc hl");
+	__asm__(" ld h,(hl)");
+	__asm__(" ld l,a");
+	__asm__(" inc hl"); // unit color line : ROM
+	__asm__(" ld a,(hl)");
+	__asm__(" dec hl");
+	__asm__(" and $40");
+	__asm__(" jp z,dai_vdot_rom");
+	__asm__(" push hl");
+	__asm__(" ld hl,$0008"); // hl = x + 8 (unused pair on the left)
+	__asm__(" add hl,de");
+	__asm__(" ld a,l"); // c = dot in byte
+	__asm__(" and $07");
+	__asm__(" ld c,a");
+	__asm__(" ld a,h"); // a = 2 * ((x + 8) / 8), offset of the pair
+	__asm__(" rra");
+	__asm__(" ld a,l");
+	__asm__(" rra");
+	__asm__(" and $FC");
+	__asm__(" rrca");
+	__asm__(" pop de"); // de = address of first byte of the pair
+	__asm__(" ld b,a");
+	__asm__(" ld a,e");
+	__asm__(" sub b");
+	__asm__(" ld e,a");
+	__asm__(" ld a,d");
+	__asm__(" sbc a,$00");
+	__asm__(" ld d,a");
+	__asm__(" ld b,$00"); // b = mask of the dot
+	__asm__(" ld hl,_dai_vmask");
+	__asm__(" add hl,bc");
+	__asm__(" ld b,(hl)");
+	__asm__(" pop af"); // color in c
+	__asm__(" push af");
+	__asm__(" ld c,a");
+	__asm__(" cp $10");
+	__asm__(" jp nc,dai_vdot_rom");
+	__asm__(" ld a,(_dai_v16)");
+	__asm__(" or a");
+	__asm__(" jp nz,dai_vdot_16");
+	// 4 colors : index bit 0 in first byte, bit 1 in second byte
+	__asm__(" push bc");
+	__asm__(" ld b,$00");
+	__asm__(" ld hl,_dai_vidx");
+	__asm__(" add hl,bc");
+	__asm__(" pop bc");
+	__asm__(" ld a,(hl)"); // palette index
+	__asm__(" cp $FF");
+	__asm__(" jp z,dai_vdot_rom");
+	__asm__(" ld h,d");
+	__asm__(" ld l,e");
+	__asm__(" rra");
+	__asm__(" ld c,a"); // index bit 1 in bit 0 of c
+	__asm__(" ld a,b");
+	__asm__(" jp nc,dai_vdot_c0");
+	__asm__(" or (hl)");
+	__asm__(" jp dai_vdot_s0");
+	__asm__("dai_vdot_c0:");
+	__asm__(" cpl");
+	__asm__(" and (hl)");
+	__asm__("dai_vdot_s0:");
+	__asm__(" ld (hl),a");
+	__asm__(" dec hl");
+	__asm__(" ld a,c");
+	__asm__(" rra");
+	__asm__(" ld a,b");
+	__asm__(" jp nc,dai_vdot_c1");
+	__asm__(" or (hl)");
+	__asm__(" jp dai_vdot_s1");
+	__asm__("dai_vdot_c1:");
+	__asm__(" cpl");
+	__asm__(" and (hl)");
+	__asm__("dai_vdot_s1:");
+	__asm__(" ld (hl),a");
+	__asm__(" jp dai_vdot_end");
+	// 16 colors : set the dot if color is the one of set dots, clear it if color is the other one
+	__asm__("dai_vdot_16:");
+	__asm__(" ld h,d");
+	__asm__(" ld l,e");
+	__asm__(" dec hl");
+	__asm__(" ld a,(_dai_vhi)");
+	__asm__(" or a");
+	__asm__(" ld a,(hl)"); // color byte
+	__asm__(" jp z,dai_vdot_lo");
+	__asm__(" rrca"); // color of set dots in low nibble
+	__asm__(" rrca");
+	__asm__(" rrca");
+	__asm__(" rrca");
+	__asm__("dai_vdot_lo:");
+	__asm__(" ld h,a");
+	__asm__(" and $0F");
+	__asm__(" cp c");
+	__asm__(" jp z,dai_vdot_set");
+	__asm__(" ld a,h");
+	__asm__(" rrca");
+	__asm__(" rrca");
+	__asm__(" rrca");
+	__asm__(" rrca");
+	__asm__(" and $0F");
+	__asm__(" cp c");
+	__asm__(" jp nz,dai_vdot_rom");
+	__asm__(" ex de,hl"); // clear the dot
+	__asm__(" ld a,b");
+	__asm__(" cpl");
+	__asm__(" and (hl)");
+	__asm__(" ld (hl),a");
+	__asm__(" jp dai_vdot_end");
+	__asm__("dai_vdot_set:");
+	__asm__(" ex de,hl"); // set the dot
+	__asm__(" ld a,b");
+	__asm__(" or (hl)");
+	__asm__(" ld (hl),a");
+	__asm__(" jp dai_vdot_end");
+	// ROM fallback with saved registers, same as dai_dot
+	__asm__("dai_vdot_rom:");
+	__asm__(" pop af");
+	__asm__(" pop bc");
+	__asm__(" pop hl");
+	__asm__(" rst 5");
+	__asm__(" defb $1E"); // call $E710 in ROM
+	__asm__(" ret");
+#ifdef DAI_BACKBUFFER
+	// dai_bbdirty(x, y, x, y), then x in hl and y in c again
+	__asm__("dai_vdot_bb:");
+	__asm__(" ld b,$00");
+	__asm__(" push hl");
+	__asm__(" push bc");
+	__asm__(" push hl");
+	__asm__(" push bc");
+	__asm__(" call _dai_bbdirty");
+	__asm__(" pop bc");
+	__asm__(" pop bc");
+	__asm__(" pop bc");
+	__asm__(" pop bc");
+	__asm__(" ld hl,$0004"); // saved bc and hl, after return address and af
+	__asm__(" add hl,sp");
+	__asm__(" ld c,(hl)");
+	__asm__(" inc hl");
+	__asm__(" ld b,(hl)");
+	__asm__(" inc hl");
+	__asm__(" ld a,(hl)");
+	__asm__(" inc hl");
+	__asm__(" ld h,(hl)");
+	__asm__(" ld l,a");
+	__asm__(" ret");
+#endif
+	__asm__("dai_vdot_end:");
+	__asm__(" pop af");
+	__asm__(" pop bc");
+	__asm__(" pop hl");
+}
@@ -0,0 +1,104 @@
+//====================================================================================
+// libdai : dai_vdraw
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vdraw 
+// -----------------------------------------------------------------------------------
+// Draw a line directly in screen memory, same result as dai_draw
+// Horizontal lines are written 8 dots at a time, vertical and diagonal lines step through
+// the rows table : they have only one possible set of dots
+// Other slopes are drawn by the ROM, whose rounding is not known to match Bresenham,
+// define DAI_VDRAW_NATIVESLOPES to draw them with integer Bresenham from x0,y0 to x1,y1
+// (always done while a back buffer is active, as the ROM only writes to the screen)
+// 16 colors modes, lines out of screen and colors not in palette use the ROM
+// Input : x0, y0, x1, y1, color
+void dai_vdraw(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint8_t c)
+{
+	static uint16_t x, off;
+	static int16_t dx, dy, err, e2;
+	static uint8_t y, idx, pt0, pt1, mk, sx, sy;
+	static uint8_t *r;
+
+	if ((dai_vok == 0) | dai_v16 | (c > 15) | (x0 > dai_vxmax) | (x1 > dai_vxmax) | (y0 > dai_vymax) | (y1 > dai_vymax)) {
+		dai_draw(x0, y0, x1, y1, c);
+		return;
+	}
+	idx = dai_vidx[c];
+	if (idx == 0xFF) {
+		dai_draw(x0, y0, x1, y1, c);
+		return;
+	}
+	pt0 = ((idx & 1) ? 0xFF : 0x00); // pattern of first and second bytes
+	pt1 = ((idx & 2) ? 0xFF : 0x00);
+#ifdef DAI_BACKBUFFER
+	if (dai_bbact) dai_bbdirty(x0, y0, x1, y1);
+#endif
+
+	// Horizontal : whole bytes between the two ends
+	if (y0 == y1) {
+		if ((dai_vrow[y0][1] & 0x40) == 0) { // unit color line
+			dai_draw(x0, y0, x1, y1, c);
+			return;
+		}
+		if (x0 > x1) dai_vhspan4(dai_vrow[y0], x1, x0, pt0, pt1);
+		else dai_vhspan4(dai_vrow[y0], x0, x1, pt0, pt1);
+		return;
+	}
+
+	dx = (x1 > x0 ? x1 - x0 : x0 - x1);
+	dy = (y1 > y0 ? y1 - y0 : y0 - y1);
+#ifndef DAI_VDRAW_NATIVESLOPES
+#ifdef DAI_BACKBUFFER
+	if ((dx != 0) & (dx != dy) & (dai_bbact == 0)) {
+#else
+	if ((dx != 0) & (dx != dy)) {
+#endif
+		dai_draw(x0, y0, x1, y1, c);
+		return;
+	}
+#endif
+
+	// Vertical, diagonal and Bresenham : same dot mask and pair offset while x does not change
+	x = x0 + 8; // unused pair on the left
+	off = (x >> 3) << 1;
+	mk = dai_vmask[x & 7];
+	sx = (x1 > x0);
+	sy = (y1 > y0);
+	y = y0;
+	err = dx - dy;
+	while (1) {
+		r = dai_vrow[y];
+		if (r[1] & 0x40) dai_vput4(r - off, mk, pt0, pt1);
+		else dai_vdot(x - 8, y, c); // unit color line
+		if (y == y1) {
+			if (x == x1 + 8) return;
+		}
+		e2 = 2 * err; // err can be negative : not a shift
+		if (e2 > -dy) {
+			err -= dy;
+			if (sx) {
+				x++;
+				mk >>= 1;
+				if (mk == 0) {
+					mk = 0x80;
+					off += 2;
+				}
+			} else {
+				x--;
+				mk <<= 1;
+				if (mk == 0) {
+					mk = 0x01;
+					off -= 2;
+				}
+			}
+		}
+		if (e2 < dx) {
+			err += dx;
+			if (sy) y++;
+			else y--;
+		}
+	}
+}
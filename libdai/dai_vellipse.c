@@ -0,0 +1,80 @@
+//====================================================================================
+// libdai : dai_vellipse
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vellipse 
+// -----------------------------------------------------------------------------------
+// Draw an ellipse or a filled ellipse, integer midpoint algorithm in two regions
+// Region 1 (slope above -1) steps x and sometimes y, region 2 steps y and sometimes x
+// One quarter is computed, each point gives 4 dots, or when y is about to change the
+// spans of rows y and -y (written once each with dai_vcspan)
+// A zero radius gives a line
+// Dots out of screen are not drawn
+// Input : center xc, yc, radii rx, ry (rx * ry at most 40000), fill = 1 for a filled
+// ellipse, color
+void dai_vellipse(uint16_t xc, uint8_t yc, uint8_t rx, uint8_t ry, uint8_t fill, uint8_t c)
+{
+	static int32_t a2, b2, px, py, p;
+	static int16_t x, y, cx, cy;
+
+	cx = xc;
+	cy = yc;
+	if ((rx == 0) | (ry == 0)) {
+		for (y = -ry; y <= ry; y++) dai_vcspan(cx - rx, cx + rx, cy + y, c);
+		return;
+	}
+	a2 = (int32_t)rx * rx;
+	b2 = (int32_t)ry * ry;
+	x = 0;
+	y = ry;
+	px = 0;
+	py = (a2 * y) << 1;
+
+	// Region 1 : x grows by one at each step
+	p = b2 - a2 * y + (a2 >> 2);
+	while (px < py) {
+		if (fill == 0) {
+			dai_vcdot(cx + x, cy + y, c);
+			dai_vcdot(cx - x, cy + y, c);
+			dai_vcdot(cx - x, cy - y, c);
+			dai_vcdot(cx + x, cy - y, c);
+		}
+		x++;
+		px += b2 << 1;
+		if (p < 0) p += b2 + px;
+		else {
+			if (fill) { // last point of row y : x - 1 is its end
+				dai_vcspan(cx - x + 1, cx + x - 1, cy + y, c);
+				dai_vcspan(cx - x + 1, cx + x - 1, cy - y, c);
+			}
+			y--;
+			py -= a2 << 1;
+			p += b2 + px - py;
+		}
+	}
+
+	// Region 2 : y goes down by one at each step
+	p = b2 * ((int32_t)x * x + x) + a2 * ((int32_t)(y - 1) * (y - 1)) - a2 * b2 + (b2 >> 2);
+	while (y >= 0) {
+		if (fill) {
+			dai_vcspan(cx - x, cx + x, cy + y, c);
+			if (y != 0) dai_vcspan(cx - x, cx + x, cy - y, c);
+		} else {
+			dai_vcdot(cx + x, cy + y, c);
+			dai_vcdot(cx - x, cy + y, c);
+			dai_vcdot(cx - x, cy - y, c);
+			dai_vcdot(cx + x, cy - y, c);
+		}
+		y--;
+		py -= a2 << 1;
+		if (p > 0) p += a2 - py;
+		else {
+			x++;
+			px += b2 << 1;
+			p += a2 - py + px;
+		}
+	}
+}
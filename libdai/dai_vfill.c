@@ -0,0 +1,49 @@
+//====================================================================================
+// libdai : dai_vfill
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vfill 
+// -----------------------------------------------------------------------------------
+// Draw a rectangle directly in screen memory, same result as dai_fill
+// Each row is written with dai_vhspan4 : whole bytes inside, masks on left and right pairs
+// 16 colors modes, rectangles out of screen and colors not in palette use the ROM,
+// unit color lines use the ROM for their row only
+// Input : x0, y0, x1, y1, color
+void dai_vfill(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint8_t c)
+{
+	static uint16_t x;
+	static uint8_t y, idx, pt0, pt1;
+
+	if ((dai_vok == 0) | dai_v16 | (c > 15) | (x0 > dai_vxmax) | (x1 > dai_vxmax) | (y0 > dai_vymax) | (y1 > dai_vymax)) {
+		dai_fill(x0, y0, x1, y1, c);
+		return;
+	}
+	idx = dai_vidx[c];
+	if (idx == 0xFF) {
+		dai_fill(x0, y0, x1, y1, c);
+		return;
+	}
+	pt0 = ((idx & 1) ? 0xFF : 0x00); // pattern of first and second bytes
+	pt1 = ((idx & 2) ? 0xFF : 0x00);
+	if (x0 > x1) {
+		x = x0;
+		x0 = x1;
+		x1 = x;
+	}
+	if (y0 > y1) {
+		y = y0;
+		y0 = y1;
+		y1 = y;
+	}
+#ifdef DAI_BACKBUFFER
+	if (dai_bbact) dai_bbdirty(x0, y0, x1, y1);
+#endif
+	for (y = y0; ; y++) {
+		if (dai_vrow[y][1] & 0x40) dai_vhspan4(dai_vrow[y], x0, x1, pt0, pt1);
+		else dai_fill(x0, y, x1, y, c); // unit color line
+		if (y == y1) break;
+	}
+}
@@ -0,0 +1,26 @@
+//====================================================================================
+// libdai : dai_vget
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vget 
+// -----------------------------------------------------------------------------------
+// Get color of dot x of a row in screen memory, without any check
+// Input : row = address of first data byte of the row, x
+uint8_t dai_vget(uint8_t *row, uint16_t x)
+{
+	static uint8_t *p;
+	static uint8_t mk, d;
+
+	x += 8; // unused pair on the left
+	p = row - ((x >> 3) << 1);
+	mk = dai_vmask[x & 7];
+	if (dai_v16) {
+		d = *(p - 1);
+		if (((*p & mk) != 0) == (dai_vhi != 0)) return d >> 4;
+		return d & 0x0F;
+	}
+	return dai_palette[((*p & mk) ? 1 : 0) | ((*(p - 1) & mk) ? 2 : 0)];
+}
@@ -0,0 +1,33 @@
+//====================================================================================
+// libdai : dai_vhspan4
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vhspan4 
+// -----------------------------------------------------------------------------------
+// Write dots x0 to x1 of a row of a 4 colors mode with one color
+// Only the first and last pairs are masked, the other ones are written as whole bytes
+// Input : row = address of first data byte of the row, x0 <= x1, pt0 and pt1 = pattern of
+// first and second bytes of the color ($00 or $FF)
+// No check on row and x
+void dai_vhspan4(uint8_t *row, uint16_t x0, uint16_t x1, uint8_t pt0, uint8_t pt1)
+{
+	static uint8_t *p, *q;
+	static uint8_t ml, mr;
+
+	x0 += 8; // unused pair on the left
+	x1 += 8;
+	p = row - ((x0 >> 3) << 1);
+	q = row - ((x1 >> 3) << 1);
+	ml = 0xFF >> (x0 & 7);
+	mr = 0xFF << (7 - (x1 & 7));
+	if (p == q) {
+		dai_vput4(p, ml & mr, pt0, pt1);
+		return;
+	}
+	dai_vput4(p, ml, pt0, pt1);
+	dai_vbytes(p - 2, (p - q - 2) >> 1, pt0, pt1);
+	dai_vput4(q, mr, pt0, pt1);
+}
@@ -0,0 +1,78 @@
+//====================================================================================
+// libdai : dai_vinit
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vinit 
+// -----------------------------------------------------------------------------------
+// Build rows table of graphic mode m, native functions are disabled if not possible
+// Graphic lines of the right resolution are collected from the top of the screen,
+// then a dot plotted by the ROM in 2 corners is used to find the first row and to
+// check the layout (dots are restored afterwards)
+// The walk through the lines also gives the lowest address of screen memory (dai_vlow)
+// Input : m, same as dai_mode
+// Called by dai_mode
+void dai_vinit(uint8_t m)
+{
+	static uint8_t *a, *r;
+	static uint16_t n, t, s;
+	static uint8_t mb, res, cb0, cb1, cr0, cr1;
+
+	dai_vok = 0;
+	dai_tok = 0; // text lines move with the mode
+	dai_ttried = 0;
+	dai_vmode = 0xFF; // dai_xmax and dai_ymax from the ROM
+#ifdef DAI_BACKBUFFER
+	dai_bbact = 0; // rows of the new mode are on the screen
+#endif
+	if (m == 0xFF) return; // text mode
+	dai_vxmax = dai_xmax();
+	dai_vymax = dai_ymax();
+	dai_vmode = m; // geometry is known, even if native functions are not possible
+	dai_v16 = ((m & 0x02) == 0);
+	res = (dai_vxmax < 80 ? 0 : (dai_vxmax < 200 ? 1 : 2));
+
+	// Collect graphic lines with the resolution of the mode, top of screen first
+	a = DAI_ADDR(0xBFFF);
+	n = 0;
+	s = 0;
+	while ((s < DAI_VSCANS) & (n < DAI_VLINES)) {
+		mb = *a;
+		if (((mb & 0x40) == 0) & (((mb >> 4) & 0x03) == res) & ((mb >> 7) == dai_v16)) {
+			dai_vrow[n] = a - 2;
+			n++;
+		}
+		s += ((mb & 0x0F) + 1) << 1;
+		a -= 2 + (dai_vpairs[(mb >> 4) & 0x03] << 1);
+	}
+	dai_vlow = a + 1; // RAM below is free for the program (ex: buffers at fixed addresses)
+	if (n <= dai_vymax) return;
+
+	// Reference dots : bottom left and top right, with a color different from the current one
+	cb0 = dai_scrn(0, 0);
+	cb1 = dai_scrn(dai_vxmax, dai_vymax);
+	cr0 = (dai_v16 ? cb0 ^ 0x08 : (dai_palette[0] != cb0 ? dai_palette[0] : dai_palette[1]));
+	cr1 = (dai_v16 ? cb1 ^ 0x08 : (dai_palette[0] != cb1 ? dai_palette[0] : dai_palette[1]));
+	dai_dot(0, 0, cr0);
+	dai_dot(dai_vxmax, dai_vymax, cr1);
+	for (t = 0; t + dai_vymax < n; t++) {
+		for (dai_vhi = 0; dai_vhi < 2; dai_vhi++) { // nibble order of 16 colors modes
+			if ((dai_vget(dai_vrow[t + dai_vymax], 0) == cr0) & (dai_vget(dai_vrow[t], dai_vxmax) == cr1)) break;
+		}
+		if (dai_vhi < 2) break;
+	}
+	dai_dot(0, 0, cb0);
+	dai_dot(dai_vxmax, dai_vymax, cb1);
+	if (t + dai_vymax >= n) return;
+
+	// Rows found from t (top) to t + ymax (bottom) : reverse them to have row 0 first
+	for (s = 0; s < (dai_vymax + 1) / 2; s++) {
+		r = dai_vrow[t + s];
+		dai_vrow[t + s] = dai_vrow[t + dai_vymax - s];
+		dai_vrow[t + dai_vymax - s] = r;
+	}
+	for (s = 0; s <= dai_vymax; s++) dai_vrow[s] = dai_vrow[t + s];
+	dai_vok = 1;
+}
@@ -0,0 +1,24 @@
+//====================================================================================
+// libdai : dai_vpalette
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vpalette 
+// -----------------------------------------------------------------------------------
+// Keep colors set by dai_colorg and build color to palette index table
+// Input : colors C0 to C3 at $0119 to $011C
+// Called by dai_colorg
+void dai_vpalette(void)
+{
+	static uint8_t i;
+
+	for (i = 0; i < 16; i++) dai_vidx[i] = 0xFF;
+	i = 4;
+	do {
+		i--;
+		dai_palette[i] = DAI_ADDR(0x0119)[i];
+		dai_vidx[dai_palette[i] & 0x0F] = i; // lowest index when a color is used twice
+	} while (i != 0);
+}
@@ -0,0 +1,17 @@
+//====================================================================================
+// libdai : dai_vput4
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vput4 
+// -----------------------------------------------------------------------------------
+// Write the dots of mask mk of a pair of a 4 colors mode with one color
+// Input : p = address of first byte of the pair, mk, pt0 and pt1 = pattern of the color
+void dai_vput4(uint8_t *p, uint8_t mk, uint8_t pt0, uint8_t pt1)
+{
+	*p = (*p & ~mk) | (pt0 & mk);
+	p--;
+	*p = (*p & ~mk) | (pt1 & mk);
+}
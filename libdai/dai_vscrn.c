@@ -0,0 +1,18 @@
+//====================================================================================
+// libdai : dai_vscrn
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vscrn 
+// -----------------------------------------------------------------------------------
+// Get color of dot from screen memory, same result as dai_scrn. 0,0 bottom left
+// Input : x, y
+// Uses Dai ROM related function when native access is not possible
+uint8_t dai_vscrn(uint16_t x, uint8_t y)
+{
+	if ((dai_vok == 0) | (x > dai_vxmax) | (y > dai_vymax)) return dai_scrn(x, y);
+	if ((dai_vrow[y][1] & 0x40) == 0) return dai_scrn(x, y); // unit color line
+	return dai_vget(dai_vrow[y], x);
+}
@@ -0,0 +1,126 @@
+//====================================================================================
+// libdai : dai_vspan4
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vspan4 
+// -----------------------------------------------------------------------------------
+// Write n dots from a color buffer in a row of a 4 colors mode, used by dai_dots
+// Stops on the first color which is not in palette
+// Input : row = address of first data byte of the row, x, n > 0, buf = colors
+// No check on row and x
+// Registers are saved except hl used for result
+// return in hl the number of dots not written (0 when done)
+uint16_t dai_vspan4(uint8_t *row, uint16_t x, uint16_t n, uint8_t *buf)
+{
+	__asm__(" push af");
+	__asm__(" push bc");
+	__asm__(" push de");
+	__asm__(" ld hl,$000A");	
+	__asm__(" add hl,sp"); 
+	__asm__(" ld c,(hl)"); // n in bc
+	__asm__(" inc hl");
+	__asm__(" ld b,(hl)");
+	__asm__(" inc hl");
+	__asm__(" ld e,(hl)"); // x in de
+	__asm__(" inc hl");
+	__asm__(" ld d,(hl)");
+	__asm__(" inc hl");
+	__asm__(" ld a,(hl)"); // row in hl
+	__asm__(" inc hl");
+	__asm__(" ld h,(hl)");
+	__asm__(" ld l,a");
+	__asm__(" push bc"); // dots left on top of stack
+	__asm__(" push hl");
+	__asm__(" ld hl,$0008"); // hl = x + 8 (unused pair on the left)
+	__asm__(" add hl,de");
+	__asm__(" ld a,l"); // c = dot in byte
+	__asm__(" and $07");
+	__asm__(" ld c,a");
+	__asm__(" ld a,h"); // a = 2 * ((x + 8) / 8), offset of the pair
+	__asm__(" rra");
+	__asm__(" ld a,l");
+	__asm__(" rra");
+	__asm__(" and $FC");
+	__asm__(" rrca");
+	__asm__(" pop hl"); // hl = address of first byte of the pair
+	__asm__(" ld b,a");
+	__asm__(" ld a,l");
+	__asm__(" sub b");
+	__asm__(" ld l,a");
+	__asm__(" ld a,h");
+	__asm__(" sbc a,$00");
+	__asm__(" ld h,a");
+	__asm__(" push hl");
+	__asm__(" ld b,$00"); // b = mask of the dot
+	__asm__(" ld hl,_dai_vmask");
+	__asm__(" add hl,bc");
+	__asm__(" ld b,(hl)");
+	__asm__(" ld hl,$000C"); // buf in de
+	__asm__(" add hl,sp"); 
+	__asm__(" ld e,(hl)");
+	__asm__(" inc hl");
+	__asm__(" ld d,(hl)");
+	__asm__(" pop hl");
+	// hl = screen, de = colors, b = mask
+	__asm__("dai_vspan4_loop:");
+	__asm__(" ld a,(de)"); // color
+	__asm__(" cp $10");
+	__asm__(" jp nc,dai_vspan4_end");
+	__asm__(" push hl"); // palette index
+	__asm__(" ld hl,_dai_vidx");
+	__asm__(" add a,l");
+	__asm__(" ld l,a");
+	__asm__(" jp nc,dai_vspan4_idx");
+	__asm__(" inc h");
+	__asm__("dai_vspan4_idx:");
+	__asm__(" ld a,(hl)");
+	__asm__(" pop hl");
+	__asm__(" cp $FF");
+	__asm__(" jp z,dai_vspan4_end");
+	__asm__(" rra"); // index bit 0 in first byte
+	__asm__(" ld c,a");
+	__asm__(" ld a,b");
+	__asm__(" jp nc,dai_vspan4_c0");
+	__asm__(" or (hl)");
+	__asm__(" jp dai_vspan4_s0");
+	__asm__("dai_vspan4_c0:");
+	__asm__(" cpl");
+	__asm__(" and (hl)");
+	__asm__("dai_vspan4_s0:");
+	__asm__(" ld (hl),a");
+	__asm__(" dec hl"); // index bit 1 in second byte
+	__asm__(" ld a,c");
+	__asm__(" rra");
+	__asm__(" ld a,b");
+	__asm__(" jp nc,dai_vspan4_c1");
+	__asm__(" or (hl)");
+	__asm__(" jp dai_vspan4_s1");
+	__asm__("dai_vspan4_c1:");
+	__asm__(" cpl");
+	__asm__(" and (hl)");
+	__asm__("dai_vspan4_s1:");
+	__asm__(" ld (hl),a");
+	__asm__(" inc hl");
+	__asm__(" inc de"); // next dot
+	__asm__(" ld a,b");
+	__asm__(" rrca");
+	__asm__(" ld b,a");
+	__asm__(" jp nc,dai_vspan4_pair");
+	__asm__(" dec hl"); // next pair
+	__asm__(" dec hl");
+	__asm__("dai_vspan4_pair:");
+	__asm__(" ex (sp),hl"); // one dot less
+	__asm__(" dec hl");
+	__asm__(" ld a,h");
+	__asm__(" or l");
+	__asm__(" ex (sp),hl");
+	__asm__(" jp nz,dai_vspan4_loop");
+	__asm__("dai_vspan4_end:");
+	__asm__(" pop hl"); // dots not written
+	__asm__(" pop de");
+	__asm__(" pop bc");
+	__asm__(" pop af");
+}
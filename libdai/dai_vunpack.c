@@ -0,0 +1,53 @@
+//====================================================================================
+// libdai : dai_vunpack
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vunpack 
+// -----------------------------------------------------------------------------------
+// Show a screen image made by tools/dai_scr.c : colors and mode of the image are set,
+// then rows are unpacked directly in screen memory, no buffer
+// Image : "DS", mode, 4 colors (as dai_colorg), xmax (2 bytes, low first), ymax, then
+// rows from row 0 (bottom), each one a list of tokens giving the data pairs of the row
+// in screen memory order (xmax + 1) / 8 pairs :
+// $00-$3F : t + 1 pairs follow
+// $40-$7F : the next pair, t - $3F times
+// $80-$FF : t - $7F pairs copied from the row below (not in row 0)
+// 16 colors modes : dots set in the first byte of a pair use the high nibble of the second
+// byte, nibbles are swapped at the end when the DAI uses the other order (dai_vhi)
+// Input : img = address of the image in memory (ex: loaded by UT R)
+// return 1 when done, 0 if this is not an image, native functions are not possible or
+// the size of the mode is not the one of the image
+uint8_t dai_vunpack(uint8_t *img)
+{
+	static uint8_t *p, *q;
+	static uint8_t y, n, i, c;
+
+	if ((img[0] != 'D') | (img[1] != 'S')) return 0;
+	dai_colorg(img[3], img[4], img[5], img[6]);
+	dai_mode(img[2]);
+	if ((dai_vok == 0) | (dai_vxmax != (img[7] | (img[8] << 8))) | (dai_vymax != img[9])) return 0;
+	n = (dai_vxmax + 1) >> 3;
+	p = img + 10;
+	for (y = 0; ; y++) {
+		if ((dai_vrow[y][1] & 0x40) == 0) { // unit color line : a dot by the ROM makes it a graphic line
+			c = dai_scrn(0, y);
+			dai_dot(0, y, (c == img[3] ? img[4] : img[3]));
+		}
+		p = dai_vunrow(p, dai_vrow[y] - 2, (y == 0 ? 0 : dai_vrow[y - 1] - dai_vrow[y]), n);
+		if (y == dai_vymax) break;
+	}
+	if (dai_v16 & (dai_vhi == 0)) { // dots set in the first byte use the low nibble
+		for (y = 0; ; y++) {
+			q = dai_vrow[y] - 3;
+			for (i = 0; i < n; i++) {
+				*q = (*q << 4) | (*q >> 4);
+				q -= 2;
+			}
+			if (y == dai_vymax) break;
+		}
+	}
+	return 1;
+}
@@ -0,0 +1,120 @@
+//====================================================================================
+// libdai : dai_vunrow
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_vunrow 
+// -----------------------------------------------------------------------------------
+// Unpack one row of a screen image, used by dai_vunpack (tokens described there)
+// Input : src = first token of the row, dst = first byte of the first pair written,
+// delta = address of the same pair in the row below minus dst, n = pairs of the row
+// No check : tokens of a row must give exactly n pairs
+// Registers are not saved
+// return in hl the address of the first token of the next row
+uint8_t *dai_vunrow(uint8_t *src, uint8_t *dst, uint16_t delta, uint8_t n)
+{
+	__asm__(" ld hl,$0002");	
+	__asm__(" add hl,sp"); 
+	__asm__(" ld c,(hl)"); // n in c, pairs left
+	__asm__(" inc hl");
+	__asm__(" inc hl");
+	__asm__(" ld e,(hl)"); // delta on top of stack
+	__asm__(" inc hl");
+	__asm__(" ld d,(hl)");
+	__asm__(" inc hl");
+	__asm__(" push de");
+	__asm__(" ld e,(hl)"); // dst in de
+	__asm__(" inc hl");
+	__asm__(" ld d,(hl)");
+	__asm__(" inc hl");
+	__asm__(" ld a,(hl)"); // src in hl
+	__asm__(" inc hl");
+	__asm__(" ld h,(hl)");
+	__asm__(" ld l,a");
+	__asm__(" ex de,hl");
+	// hl = screen (downward), de = tokens, c = pairs left, b = pairs of the token
+	__asm__("dai_vunrow_tok:");
+	__asm__(" ld a,c");
+	__asm__(" or a");
+	__asm__(" jp z,dai_vunrow_end");
+	__asm__(" ld a,(de)"); // token
+	__asm__(" inc de");
+	__asm__(" or a");
+	__asm__(" jp m,dai_vunrow_copy");
+	__asm__(" cp $40");
+	__asm__(" jp nc,dai_vunrow_rep");
+	__asm__(" inc a"); // $00-$3F : pairs follow
+	__asm__(" ld b,a");
+	__asm__(" ld a,c");
+	__asm__(" sub b");
+	__asm__(" ld c,a");
+	__asm__("dai_vunrow_lit:");
+	__asm__(" ld a,(de)");
+	__asm__(" inc de");
+	__asm__(" ld (hl),a");
+	__asm__(" dec hl");
+	__asm__(" ld a,(de)");
+	__asm__(" inc de");
+	__asm__(" ld (hl),a");
+	__asm__(" dec hl");
+	__asm__(" dec b");
+	__asm__(" jp nz,dai_vunrow_lit");
+	__asm__(" jp dai_vunrow_tok");
+	__asm__("dai_vunrow_rep:"); // $40-$7F : next pair repeated
+	__asm__(" and $3F");
+	__asm__(" inc a");
+	__asm__(" ld b,a");
+	__asm__(" ld a,c");
+	__asm__(" sub b");
+	__asm__(" ld c,a");
+	__asm__("dai_vunrow_rpl:");
+	__asm__(" ld a,(de)");
+	__asm__(" ld (hl),a");
+	__asm__(" dec hl");
+	__asm__(" inc de");
+	__asm__(" ld a,(de)");
+	__asm__(" ld (hl),a");
+	__asm__(" dec hl");
+	__asm__(" dec de");
+	__asm__(" dec b");
+	__asm__(" jp nz,dai_vunrow_rpl");
+	__asm__(" inc de");
+	__asm__(" inc de");
+	__asm__(" jp dai_vunrow_tok");
+	__asm__("dai_vunrow_copy:"); // $80-$FF : pairs of the row below
+	__asm__(" and $7F");
+	__asm__(" inc a");
+	__asm__(" ld b,a");
+	__asm__(" ld a,c");
+	__asm__(" sub b");
+	__asm__(" ld c,a");
+	__asm__(" push de"); // tokens, delta is now at sp + 2
+	__asm__(" ld d,h"); // de = screen
+	__asm__(" ld e,l");
+	__asm__(" ld hl,$0002");
+	__asm__(" add hl,sp");
+	__asm__(" ld a,(hl)");
+	__asm__(" inc hl");
+	__asm__(" ld h,(hl)");
+	__asm__(" ld l,a");
+	__asm__(" add hl,de"); // hl = same pair in the row below
+	__asm__("dai_vunrow_cpl:");
+	__asm__(" ld a,(hl)");
+	__asm__(" ld (de),a");
+	__asm__(" dec hl");
+	__asm__(" dec de");
+	__asm__(" ld a,(hl)");
+	__asm__(" ld (de),a");
+	__asm__(" dec hl");
+	__asm__(" dec de");
+	__asm__(" dec b");
+	__asm__(" jp nz,dai_vunrow_cpl");
+	__asm__(" ex de,hl");
+	__asm__(" pop de");
+	__asm__(" jp dai_vunrow_tok");
+	__asm__("dai_vunrow_end:");
+	__asm__(" pop bc"); // delta
+	__asm__(" ex de,hl"); // next token in hl
+}
@@ -0,0 +1,36 @@
+//====================================================================================
+// libdai : dai_xmax
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_xmax 
+// -----------------------------------------------------------------------------------
+// get xmax of a graphic screen. 0,0 bottom left
+// Registers are saved except hl used for result
+// Read from the graphics context when the mode was set by dai_mode (75 T states),
+// otherwise uses Dai ROM related function
+// return in hl
+uint16_t dai_xmax(void)
+{
+	__asm__(" push af");
+	__asm__(" ld a,(_dai_vmode)");
+	__asm__(" inc a"); // 0xFF : not set
+	__asm__(" jp z,dai_xmax_rom");
+	__asm__(" ld hl,(_dai_vxmax)");
+	__asm__(" pop af");
+	__asm__(" ret");
+	__asm__("dai_xmax_rom:");
+	__asm__(" push bc");
+	__asm__(" push de");
+	__asm__(" ld hl,$0000"); // x in hl
+	__asm__(" ld c,$00"); // y in c
+	__asm__(" rst 5");
+	__asm__(" defb $27"); // call $E884 in ROM, return a=color, b=ymax, de=xmax
+	__asm__(" ld h,d"); // xmax in hl
+	__asm__(" ld l,e"); 
+	__asm__(" pop de");
+	__asm__(" pop bc");
+	__asm__(" pop af");
+}
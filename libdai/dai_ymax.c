@@ -0,0 +1,38 @@
+//====================================================================================
+// libdai : dai_ymax
+//====================================================================================
+#include "dai.h"
+
+
+// -----------------------------------------------------------------------------------
+// dai_ymax 
+// -----------------------------------------------------------------------------------
+// get ymax of a graphic screen. 0,0 bottom left
+// Registers are saved except hl used for result
+// Read from the graphics context when the mode was set by dai_mode (84 T states),
+// otherwise uses Dai ROM related function
+// return in hl
+uint8_t dai_ymax(void)
+{
+	__asm__(" push af");
+	__asm__(" ld a,(_dai_vmode)");
+	__asm__(" inc a"); // 0xFF : not set
+	__asm__(" jp z,dai_ymax_rom");
+	__asm__(" ld a,(_dai_vymax)");
+	__asm__(" ld l,a");
+	__asm__(" ld h,$00");
+	__asm__(" pop af");
+	__asm__(" ret");
+	__asm__("dai_ymax_rom:");
+	__asm__(" push bc");
+	__asm__(" push de");
+	__asm__(" ld hl,$0000"); // x in hl
+	__asm__(" ld c,$00"); // y in c
+	__asm__(" rst 5");
+	__asm__(" defb $27"); // call $E884 in ROM, return a=color, b=ymax, de=xmax
+	__asm__(" ld h,$00"); // ymax in hl
+	__asm__(" ld l,b"); 
+	__asm__(" pop de");
+	__asm__(" pop bc");
+	__asm__(" pop af");
+}
@@ -0,0 +1,877 @@
+//====================================================================================
+// dai_bench : host benchmark of z88dk DAI programs on an 8080 emulator
+//====================================================================================
+// Runs a.bin (built by zcc +dai -m ...) on an 8080 with T states of the Intel data
+// sheet, and a stand-in for the DAI ROM graphic routines and screen memory.
+// Reports T states per call of each C function found in a.map, whole run included.
+//
+// Build (Linux) : cc -O2 -o dai_bench tools/dai_bench.c
+// Usage : dai_bench [options] a.bin a.map
+// -e symbol  : run this function instead of main (ex: -e _test_graphics)
+// -n cycles  : stop after this number of T states (default 20000000000)
+// -r tstates : T states charged for each ROM routine call (default 0, not counted)
+// -b file    : previous results, report functions slower by more than -p percent
+// -p percent : regression threshold (default 5)
+// -t         : print characters sent to the ROM on stderr
+// Exit code 0, 1 on error, 2 when a regression is found
+//
+// Output (stdout), one CSV record per line :
+// run,<entry>,<stop reason>,<T states>,<instructions>,<ROM calls>
+// func,<symbol>,<calls>,<T states inclusive>,<T states per call>,<min>,<max>
+// rom,<rst 5 code>,<calls>
+// regress,<symbol>,<previous per call>,<new per call>
+//
+// Example, reduced Mandelbrot windows :
+// zcc +dai -m -create-app --math-mbf32 -DFX_XMAX=83 -DFX_YMAX=63 a.c
+// dai_bench -e _mandelbrot_ms a.bin a.map > ms.csv
+// dai_bench -e _mandelbrot_ms -b ms.csv a.bin a.map
+//
+// ROM stand-in : the screen memory of a mode is built with the layout read by dai_vinit
+// (graphic rows from $BFFF downward, padding unit color lines on top, 4 text lines at
+// the bottom in A modes), dot, draw, fill and scrn work on this memory. The results are
+// close to the DAI for the native functions of the program, but the ROM code itself is
+// not emulated : its timings must be measured on a DAI or given with -r.
+// Calls to other ROM addresses return at once, a jump to the ROM ends the run.
+// The program ends on halt, on a jump to itself (while(1);) or on return from main.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//====================================================================================
+// Definitions
+//====================================================================================
+#define ORG_DEFAULT 0x0800 // G0800 on the DAI
+#define SP_DEFAULT 0xF900 // stack from $F800 to $F8FF
+#define ROM_START 0xC000
+#define RST5 0x0028
+#define TRAP 0x0000 // return address of the entry function
+#define MAX_SYMS 4096
+#define MAX_FRAMES 256
+#define DAI_VSCANS 604
+
+typedef struct {
+	char name[128];
+	uint16_t addr;
+	uint64_t calls, t, tmin, tmax;
+} sym_t;
+
+typedef struct {
+	int sym;
+	uint16_t sp; // sp after the call
+	uint64_t t0;
+} frame_t;
+
+
+//====================================================================================
+// Global variables
+//====================================================================================
+static uint8_t mem[65536];
+
+// 8080 registers and flags
+static uint8_t ra, rb, rc, rd, re, rh, rl;
+static uint16_t sp, pc;
+static uint8_t fs, fz, fac, fp, fcy;
+static uint64_t cycles, instrs;
+static int halted, called; // called : last instruction was a call or rst
+
+// Symbols and call frames
+static sym_t syms[MAX_SYMS];
+static int nsyms;
+static int16_t symat[65536]; // symbol index of each address, -1 if none
+static frame_t frames[MAX_FRAMES];
+static int nframes;
+
+// ROM stand-in
+static uint64_t romcalls, romcode[256];
+static int romcost, echo;
+static uint8_t palette[4] = {0, 5, 10, 15};
+static uint8_t vmode = 0xFF, v16;
+static uint16_t vxmax;
+static uint8_t vymax;
+static uint16_t vrow[256]; // address of first data byte of each row, row 0 at bottom
+static uint8_t curx, cury;
+
+
+//====================================================================================
+// 8080 EMULATOR
+//====================================================================================
+
+static uint8_t parity(uint8_t v)
+{
+	v ^= v >> 4;
+	v ^= v >> 2;
+	v ^= v >> 1;
+	return (v & 1) == 0;
+}
+
+static void szp(uint8_t v)
+{
+	fs = v >> 7;
+	fz = (v == 0);
+	fp = parity(v);
+}
+
+static uint8_t getf(void)
+{
+	return (fs << 7) | (fz << 6) | (fac << 4) | (fp << 2) | 0x02 | fcy;
+}
+
+static void setf(uint8_t f)
+{
+	fs = (f >> 7) & 1;
+	fz = (f >> 6) & 1;
+	fac = (f >> 4) & 1;
+	fp = (f >> 2) & 1;
+	fcy = f & 1;
+}
+
+static uint16_t rd16(uint16_t a)
+{
+	return mem[a] | (mem[(uint16_t)(a + 1)] << 8);
+}
+
+static void wr16(uint16_t a, uint16_t v)
+{
+	mem[a] = v & 0xFF;
+	mem[(uint16_t)(a + 1)] = v >> 8;
+}
+
+static void push(uint16_t v)
+{
+	sp -= 2;
+	wr16(sp, v);
+}
+
+static uint16_t pop(void)
+{
+	uint16_t v = rd16(sp);
+	sp += 2;
+	return v;
+}
+
+static uint16_t fetch16(void)
+{
+	uint16_t v = rd16(pc);
+	pc += 2;
+	return v;
+}
+
+// Register r of instruction fields : B C D E H L M A
+static uint8_t getr(int r)
+{
+	switch (r) {
+	case 0: return rb;
+	case 1: return rc;
+	case 2: return rd;
+	case 3: return re;
+	case 4: return rh;
+	case 5: return rl;
+	case 6: return mem[(rh << 8) | rl];
+	default: return ra;
+	}
+}
+
+static void setr(int r, uint8_t v)
+{
+	switch (r) {
+	case 0: rb = v; break;
+	case 1: rc = v; break;
+	case 2: rd = v; break;
+	case 3: re = v; break;
+	case 4: rh = v; break;
+	case 5: rl = v; break;
+	case 6: mem[(rh << 8) | rl] = v; break;
+	default: ra = v; break;
+	}
+}
+
+// Register pair rp : BC DE HL SP
+static uint16_t getrp(int rp)
+{
+	switch (rp) {
+	case 0: return (rb << 8) | rc;
+	case 1: return (rd << 8) | re;
+	case 2: return (rh << 8) | rl;
+	default: return sp;
+	}
+}
+
+static void setrp(int rp, uint16_t v)
+{
+	switch (rp) {
+	case 0: rb = v >> 8; rc = v & 0xFF; break;
+	case 1: rd = v >> 8; re = v & 0xFF; break;
+	case 2: rh = v >> 8; rl = v & 0xFF; break;
+	default: sp = v; break;
+	}
+}
+
+static int cond(int cc)
+{
+	switch (cc) {
+	case 0: return !fz;
+	case 1: return fz;
+	case 2: return !fcy;
+	case 3: return fcy;
+	case 4: return !fp;
+	case 5: return fp;
+	case 6: return !fs;
+	default: return fs;
+	}
+}
+
+// ADD ADC SUB SBB ANA XRA ORA CMP
+static void alu(int op, uint8_t v)
+{
+	unsigned r;
+
+	switch (op) {
+	case 0: case 1: // add, adc
+		r = ra + v + (op == 1 ? fcy : 0);
+		fac = ((ra & 0x0F) + (v & 0x0F) + (op == 1 ? fcy : 0)) > 0x0F;
+		fcy = r > 0xFF;
+		ra = r & 0xFF;
+		szp(ra);
+		break;
+	case 2: case 3: case 7: // sub, sbb, cmp
+		r = ra - v - (op == 3 ? fcy : 0);
+		fac = ((ra & 0x0F) + (~v & 0x0F) + (op == 3 ? !fcy : 1)) > 0x0F;
+		fcy = (r >> 8) & 1;
+		szp(r & 0xFF);
+		if (op != 7) ra = r & 0xFF;
+		break;
+	case 4: // ana
+		fac = ((ra | v) & 0x08) != 0;
+		ra &= v;
+		fcy = 0;
+		szp(ra);
+		break;
+	case 5: // xra
+		ra ^= v;
+		fac = fcy = 0;
+		szp(ra);
+		break;
+	default: // ora
+		ra |= v;
+		fac = fcy = 0;
+		szp(ra);
+		break;
+	}
+}
+
+
+// -----------------------------------------------------------------------------------
+// Call frames : T states of each called symbol, call and return included
+// -----------------------------------------------------------------------------------
+static void frame_call(uint16_t target)
+{
+	if (symat[target] < 0) return;
+	if (nframes == MAX_FRAMES) return;
+	frames[nframes].sym = symat[target];
+	frames[nframes].sp = sp;
+	frames[nframes].t0 = cycles;
+	nframes++;
+}
+
+// sp is the stack pointer before the return address is popped. Callee functions pop
+// their return address and push it again higher : every frame at or below sp ended
+// t_ret : T states of the return instruction, not yet added
+static void frame_ret(int t_ret)
+{
+	sym_t *s;
+	uint64_t t;
+
+	while ((nframes > 0) && (frames[nframes - 1].sp <= sp)) {
+		nframes--;
+		s = &syms[frames[nframes].sym];
+		t = cycles + t_ret - frames[nframes].t0;
+		if (s->calls == 0 || t < s->tmin) s->tmin = t;
+		if (t > s->tmax) s->tmax = t;
+		s->calls++;
+		s->t += t;
+	}
+}
+
+static void do_ret(int t)
+{
+	frame_ret(t);
+	pc = pop();
+}
+
+static void do_call(uint16_t target, uint16_t ret)
+{
+	push(ret);
+	frame_call(target);
+	pc = target;
+	called = 1;
+}
+
+
+// -----------------------------------------------------------------------------------
+// step : execute one instruction, add its T states
+// -----------------------------------------------------------------------------------
+static void step(void)
+{
+	uint8_t op, v;
+	uint16_t w, at;
+	unsigned r;
+	int t = 4;
+
+	at = pc;
+	op = mem[pc++];
+	called = 0;
+	instrs++;
+
+	if ((op & 0xC0) == 0x40) { // mov
+		if (op == 0x76) {
+			halted = 1;
+			t = 7;
+		} else {
+			setr((op >> 3) & 7, getr(op & 7));
+			t = (((op & 7) == 6) || (((op >> 3) & 7) == 6)) ? 7 : 5;
+		}
+		cycles += t;
+		return;
+	}
+	if ((op & 0xC0) == 0x80) { // alu r
+		alu((op >> 3) & 7, getr(op & 7));
+		cycles += ((op & 7) == 6) ? 7 : 4;
+		return;
+	}
+
+	switch (op) {
+	case 0x00: case 0x08: case 0x10: case 0x18: case 0x20: case 0x28: case 0x30: case 0x38:
+		t = 4; // nop
+		break;
+	case 0x01: case 0x11: case 0x21: case 0x31: // lxi
+		setrp(op >> 4, fetch16());
+		t = 10;
+		break;
+	case 0x02: case 0x12: // stax
+		mem[getrp(op >> 4)] = ra;
+		t = 7;
+		break;
+	case 0x0A: case 0x1A: // ldax
+		ra = mem[getrp(op >> 4)];
+		t = 7;
+		break;
+	case 0x03: case 0x13: case 0x23: case 0x33: // inx
+		setrp(op >> 4, getrp(op >> 4) + 1);
+		t = 5;
+		break;
+	case 0x0B: case 0x1B: case 0x2B: case 0x3B: // dcx
+		setrp(op >> 4, getrp(op >> 4) - 1);
+		t = 5;
+		break;
+	case 0x09: case 0x19: case 0x29: case 0x39: // dad
+		r = getrp(2) + getrp(op >> 4);
+		fcy = r > 0xFFFF;
+		setrp(2, r & 0xFFFF);
+		t = 10;
+		break;
+	case 0x04: case 0x0C: case 0x14: case 0x1C: case 0x24: case 0x2C: case 0x34: case 0x3C: // inr
+		v = getr((op >> 3) & 7) + 1;
+		setr((op >> 3) & 7, v);
+		fac = (v & 0x0F) == 0;
+		szp(v);
+		t = (((op >> 3) & 7) == 6) ? 10 : 5;
+		break;
+	case 0x05: case 0x0D: case 0x15: case 0x1D: case 0x25: case 0x2D: case 0x35: case 0x3D: // dcr
+		v = getr((op >> 3) & 7) - 1;
+		setr((op >> 3) & 7, v);
+		fac = (v & 0x0F) != 0x0F;
+		szp(v);
+		t = (((op >> 3) & 7) == 6) ? 10 : 5;
+		break;
+	case 0x06: case 0x0E: case 0x16: case 0x1E: case 0x26: case 0x2E: case 0x36: case 0x3E: // mvi
+		setr((op >> 3) & 7, mem[pc++]);
+		t = (((op >> 3) & 7) == 6) ? 10 : 7;
+		break;
+	case 0x07: // rlc
+		fcy = ra >> 7;
+		ra = (ra << 1) | fcy;
+		break;
+	case 0x0F: // rrc
+		fcy = ra & 1;
+		ra = (ra >> 1) | (fcy << 7);
+		break;
+	case 0x17: // ral
+		v = fcy;
+		fcy = ra >> 7;
+		ra = (ra << 1) | v;
+		break;
+	case 0x1F: // rar
+		v = fcy;
+		fcy = ra & 1;
+		ra = (ra >> 1) | (v << 7);
+		break;
+	case 0x22: // shld
+		wr16(fetch16(), getrp(2));
+		t = 16;
+		break;
+	case 0x2A: // lhld
+		setrp(2, rd16(fetch16()));
+		t = 16;
+		break;
+	case 0x27: // daa
+		v = 0;
+		r = fcy;
+		if (((ra & 0x0F) > 9) || fac) v = 0x06;
+		if ((ra > 0x99) || fcy) {
+			v |= 0x60;
+			r = 1;
+		}
+		alu(0, v);
+		fcy = r;
+		break;
+	case 0x2F: // cma
+		ra = ~ra;
+		break;
+	case 0x32: // sta
+		mem[fetch16()] = ra;
+		t = 13;
+		break;
+	case 0x3A: // lda
+		ra = mem[fetch16()];
+		t = 13;
+		break;
+	case 0x37: // stc
+		fcy = 1;
+		break;
+	case 0x3F: // cmc
+		fcy ^= 1;
+		break;
+	case 0xC0: case 0xC8: case 0xD0: case 0xD8: case 0xE0: case 0xE8: case 0xF0: case 0xF8: // rcc
+		if (cond((op >> 3) & 7)) {
+			do_ret(11);
+			t = 11;
+		} else t = 5;
+		break;
+	case 0xC9: case 0xD9: // ret
+		do_ret(10);
+		t = 10;
+		break;
+	case 0xC1: case 0xD1: case 0xE1: // pop
+		setrp((op >> 4) & 3, pop());
+		t = 10;
+		break;
+	case 0xF1: // pop psw
+		w = pop();
+		setf(w & 0xFF);
+		ra = w >> 8;
+		t = 10;
+		break;
+	case 0xC5: case 0xD5: case 0xE5: // push
+		push(getrp((op >> 4) & 3));
+		t = 11;
+		break;
+	case 0xF5: // push psw
+		push((ra << 8) | getf());
+		t = 11;
+		break;
+	case 0xC2: case 0xCA: case 0xD2: case 0xDA: case 0xE2: case 0xEA: case 0xF2: case 0xFA: // jcc
+		w = fetch16();
+		if (cond((op >> 3) & 7)) pc = w;
+		t = 10;
+		break;
+	case 0xC3: case 0xCB: // jmp
+		w = fetch16();
+		if (w == at) halted = 2; // while(1);
+		pc = w;
+		t = 10;
+		break;
+	case 0xC4: case 0xCC: case 0xD4: case 0xDC: case 0xE4: case 0xEC: case 0xF4: case 0xFC: // ccc
+		w = fetch16();
+		if (cond((op >> 3) & 7)) {
+			do_call(w, pc);
+			t = 17;
+		} else t = 11;
+		break;
+	case 0xCD: case 0xDD: case 0xED: case 0xFD: // call
+		w = fetch16();
+		do_call(w, pc);
+		t = 17;
+		break;
+	case 0xC6: case 0xCE: case 0xD6: case 0xDE: case 0xE6: case 0xEE: case 0xF6: case 0xFE: // alu immediate
+		alu((op >> 3) & 7, mem[pc++]);
+		t = 7;
+		break;
+	case 0xC7: case 0xCF: case 0xD7: case 0xDF: case 0xE7: case 0xEF: case 0xF7: case 0xFF: // rst
+		push(pc);
+		pc = op & 0x38;
+		called = 1;
+		t = 11;
+		break;
+	case 0xE3: // xthl
+		w = rd16(sp);
+		wr16(sp, getrp(2));
+		setrp(2, w);
+		t = 18;
+		break;
+	case 0xE9: // pchl
+		pc = getrp(2);
+		t = 5;
+		break;
+	case 0xEB: // xchg
+		w = getrp(1);
+		setrp(1, getrp(2));
+		setrp(2, w);
+		break;
+	case 0xF9: // sphl
+		sp = getrp(2);
+		t = 5;
+		break;
+	case 0xD3: case 0xDB: // out, in
+		pc++;
+		if (op == 0xDB) ra = 0xFF;
+		t = 10;
+		break;
+	case 0xF3: case 0xFB: // di, ei
+		break;
+	}
+	cycles += t;
+}
+
+
+//====================================================================================
+// DAI ROM STAND-IN
+//====================================================================================
+
+// -----------------------------------------------------------------------------------
+// Screen memory : one line is mode byte, color byte, pairs of data bytes
+// -----------------------------------------------------------------------------------
+static uint16_t vline(uint16_t a, uint8_t mb, uint8_t cb, int pairs)
+{
+	mem[a] = mb;
+	mem[a - 1] = cb;
+	memset(&mem[a - 1 - 2 * pairs], 0, 2 * pairs);
+	return a - 2 - 2 * pairs;
+}
+
+// m as dai_mode : bit 0 = A mode (4 text lines), bit 1 = 4 colors, m >> 2 = resolution
+static void vbuild(uint8_t m)
+{
+	static const int pairs[3] = {11, 22, 44};
+	static const int xmaxs[3] = {71, 159, 335};
+	static const int ymaxs[3] = {64, 129, 255};
+	static const int reps[3] = {3, 1, 0};
+	uint16_t a = 0xBFFF;
+	int res, scans, n, y, rep;
+
+	vmode = m;
+	if (m == 0xFF || (m >> 2) > 2) {
+		vmode = 0xFF;
+		vxmax = 59;
+		vymax = 23;
+		return;
+	}
+	res = m >> 2;
+	v16 = ((m & 0x02) == 0);
+	vxmax = xmaxs[res];
+	vymax = ymaxs[res];
+	scans = DAI_VSCANS - (vymax + 1) * 2 * (reps[res] + 1) - ((m & 1) ? 4 * 20 : 0);
+	while (scans > 0) { // unit color padding lines on top
+		rep = scans / 2 - 1;
+		if (rep > 15) rep = 15;
+		if (rep < 0) rep = 0;
+		a = vline(a, 0x30 | rep, 0x00, 66);
+		scans -= 2 * (rep + 1);
+	}
+	for (n = vymax; n >= 0; n--) { // graphic rows, top first
+		vrow[n] = a - 2;
+		a = vline(a, (v16 ? 0x80 : 0x00) | (res << 4) | reps[res], 0x40, pairs[res]);
+	}
+	if (m & 1) for (y = 0; y < 4; y++) a = vline(a, 0x70 | 9, 0x40, 66); // text lines
+}
+
+// Address of first byte of the pair of dot x in row y, mask of the dot
+static uint16_t vpair(uint16_t x, uint8_t y, uint8_t *mk)
+{
+	x += 8; // unused pair on the left
+	*mk = 0x80 >> (x & 7);
+	return vrow[y] - ((x >> 3) << 1);
+}
+
+static uint8_t vscrn(uint16_t x, uint8_t y)
+{
+	uint16_t p;
+	uint8_t mk;
+
+	if (vmode == 0xFF || x > vxmax || y > vymax) return 0;
+	p = vpair(x, y, &mk);
+	if (v16) return (mem[p] & mk) ? mem[p - 1] >> 4 : mem[p - 1] & 0x0F;
+	return palette[((mem[p] & mk) ? 1 : 0) | ((mem[p - 1] & mk) ? 2 : 0)];
+}
+
+static void vdot(uint16_t x, uint8_t y, uint8_t c)
+{
+	uint16_t p;
+	uint8_t mk, hi, lo;
+	int i;
+
+	if (vmode == 0xFF || x > vxmax || y > vymax) return;
+	c &= 0x0F;
+	p = vpair(x, y, &mk);
+	if (v16) { // set dots use the high nibble of the color byte
+		hi = mem[p - 1] >> 4;
+		lo = mem[p - 1] & 0x0F;
+		if (c == hi) mem[p] |= mk;
+		else if (c == lo) mem[p] &= ~mk;
+		else if ((mem[p] & ~mk) == 0) { // no other set dot : new color for set dots
+			mem[p - 1] = (c << 4) | lo;
+			mem[p] |= mk;
+		} else if ((mem[p] | mk) == 0xFF) { // no other clear dot
+			mem[p - 1] = (hi << 4) | c;
+			mem[p] &= ~mk;
+		} else {
+			mem[p - 1] = (c << 4) | lo;
+			mem[p] |= mk;
+		}
+		return;
+	}
+	for (i = 0; i < 4; i++) if (palette[i] == c) break;
+	if (i == 4) return; // not in palette
+	mem[p] = (i & 1) ? mem[p] | mk : mem[p] & ~mk;
+	mem[p - 1] = (i & 2) ? mem[p - 1] | mk : mem[p - 1] & ~mk;
+}
+
+static void vdraw(int x0, int y0, int x1, int y1, uint8_t c)
+{
+	int dx = abs(x1 - x0), dy = abs(y1 - y0), sx = x1 > x0 ? 1 : -1, sy = y1 > y0 ? 1 : -1;
+	int err = dx - dy, e2;
+
+	while (1) {
+		vdot(x0, y0, c);
+		if (x0 == x1 && y0 == y1) return;
+		e2 = 2 * err;
+		if (e2 > -dy) {
+			err -= dy;
+			x0 += sx;
+		}
+		if (e2 < dx) {
+			err += dx;
+			y0 += sy;
+		}
+	}
+}
+
+
+// -----------------------------------------------------------------------------------
+// rom5 : routine of rst 5, code in the byte following rst
+// -----------------------------------------------------------------------------------
+static void rom5(void)
+{
+	uint16_t ret = rd16(sp);
+	uint8_t code = mem[ret];
+	int x, y, x0, x1, y0, y1;
+
+	wr16(sp, ret + 1);
+	romcalls++;
+	romcode[code]++;
+	cycles += romcost;
+	switch (code) {
+	case 0x03: // character output
+		if (echo) fputc(ra == 0x0D ? '\n' : ra, stderr);
+		break;
+	case 0x06: // colort
+		break;
+	case 0x09: // cursor
+		curx = rl;
+		cury = rh;
+		break;
+	case 0x0C: // get cursor
+		rl = curx;
+		rh = cury;
+		re = 59;
+		rd = 23;
+		break;
+	case 0x18: // mode
+		vbuild(ra);
+		break;
+	case 0x1B: // colorg
+		memcpy(palette, &mem[getrp(2)], 4);
+		break;
+	case 0x1E: // dot
+		vdot(getrp(2), rc, ra);
+		break;
+	case 0x21: // draw
+		vdraw(getrp(2), rc, getrp(1), rb, ra);
+		break;
+	case 0x24: // fill
+		x0 = getrp(2);
+		x1 = getrp(1);
+		y0 = rc < rb ? rc : rb;
+		y1 = rc < rb ? rb : rc;
+		if (x0 > x1) {
+			x = x0;
+			x0 = x1;
+			x1 = x;
+		}
+		for (y = y0; y <= y1; y++) for (x = x0; x <= x1; x++) vdot(x, y, ra);
+		break;
+	case 0x27: // scrn
+		ra = vscrn(getrp(2), rc);
+		rb = vymax;
+		setrp(1, vxmax);
+		break;
+	}
+	do_ret(0); // ROM timings are not known
+}
+
+
+//====================================================================================
+// MAIN
+//====================================================================================
+
+static int load_map(const char *name, uint16_t *org)
+{
+	FILE *f = fopen(name, "r");
+	char line[512], sym[128];
+	unsigned addr;
+
+	if (f == NULL) return 0;
+	while (fgets(line, sizeof(line), f)) {
+		if (sscanf(line, " %127s = $%x", sym, &addr) != 2) continue;
+		if (strcmp(sym, "__crt_org_code") == 0 || strcmp(sym, "CRT_ORG_CODE") == 0) *org = addr;
+		if (sym[0] != '_' || sym[1] == '_' || strstr(line, "const") != NULL) continue;
+		if (nsyms == MAX_SYMS || symat[addr & 0xFFFF] >= 0) continue;
+		snprintf(syms[nsyms].name, sizeof(syms[nsyms].name), "%s", sym);
+		syms[nsyms].addr = addr;
+		symat[addr & 0xFFFF] = nsyms;
+		nsyms++;
+	}
+	fclose(f);
+	return 1;
+}
+
+static int find_sym(const char *name)
+{
+	int i;
+
+	for (i = 0; i < nsyms; i++) if (strcmp(syms[i].name, name) == 0) return i;
+	return -1;
+}
+
+// Compare with previous results, print regressions
+static int compare(const char *name, int pct)
+{
+	FILE *f = fopen(name, "r");
+	char line[512], sym[128];
+	unsigned long long calls, t, per;
+	int i, n = 0;
+	uint64_t now;
+
+	if (f == NULL) {
+		fprintf(stderr, "dai_bench: cannot read %s\n", name);
+		return 0;
+	}
+	while (fgets(line, sizeof(line), f)) {
+		if (sscanf(line, "func,%127[^,],%llu,%llu,%llu", sym, &calls, &t, &per) != 4) continue;
+		i = find_sym(sym);
+		if (i < 0 || syms[i].calls == 0) continue;
+		now = syms[i].t / syms[i].calls;
+		if (now * 100 > per * (100 + pct)) {
+			printf("regress,%s,%llu,%llu\n", sym, per, (unsigned long long)now);
+			n++;
+		}
+	}
+	fclose(f);
+	return n;
+}
+
+int main(int argc, char **argv)
+{
+	const char *entry = "_main", *base = NULL, *stop;
+	uint64_t limit = 20000000000ULL;
+	uint16_t org = ORG_DEFAULT;
+	int pct = 5, i, e, started = 0;
+	FILE *f;
+	size_t n;
+
+	for (i = 1; i < argc - 2; i++) {
+		if (strcmp(argv[i], "-e") == 0 && i + 1 < argc - 2) entry = argv[++i];
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc - 2) limit = strtoull(argv[++i], NULL, 0);
+		else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc - 2) romcost = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc - 2) base = argv[++i];
+		else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc - 2) pct = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-t") == 0) echo = 1;
+		else break;
+	}
+	if (argc < 3 || i != argc - 2) {
+		fprintf(stderr, "usage: dai_bench [-e symbol] [-n cycles] [-r tstates] [-b file] [-p percent] [-t] a.bin a.map\n");
+		return 1;
+	}
+	memset(symat, 0xFF, sizeof(symat));
+	if (!load_map(argv[argc - 1], &org)) {
+		fprintf(stderr, "dai_bench: cannot read %s\n", argv[argc - 1]);
+		return 1;
+	}
+	f = fopen(argv[argc - 2], "rb");
+	if (f == NULL) {
+		fprintf(stderr, "dai_bench: cannot read %s\n", argv[argc - 2]);
+		return 1;
+	}
+	n = fread(&mem[org], 1, 0x10000 - org, f);
+	fclose(f);
+	e = find_sym(entry);
+	if (n == 0 || e < 0 || find_sym("_main") < 0) {
+		fprintf(stderr, "dai_bench: empty binary or %s not in map\n", entry);
+		return 1;
+	}
+	vbuild(0xFF);
+
+	// crt start up until main, then entry called with a trap as return address
+	pc = org;
+	sp = SP_DEFAULT;
+	stop = "limit";
+	while (cycles < limit) {
+		if (!started && pc == syms[find_sym("_main")].addr) {
+			started = 1;
+			if (called) sp += 2; // return address to the crt is not used
+			nframes = 0;
+			cycles = instrs = romcalls = 0;
+			memset(romcode, 0, sizeof(romcode));
+			push(TRAP);
+			frame_call(syms[e].addr);
+			pc = syms[e].addr;
+		}
+		if (started && pc == TRAP) {
+			stop = "return";
+			break;
+		}
+		if (pc == RST5 && called) {
+			rom5();
+			continue;
+		}
+		if (pc >= ROM_START && pc < 0xF000) {
+			if (!called) {
+				stop = "rom";
+				break;
+			}
+			romcalls++;
+			cycles += romcost;
+			do_ret(0);
+			continue;
+		}
+		step();
+		if (halted) {
+			stop = (halted == 2 ? "loop" : "halt");
+			break;
+		}
+	}
+
+	printf("run,%s,%s,%llu,%llu,%llu\n", entry, stop, (unsigned long long)cycles,
+		(unsigned long long)instrs, (unsigned long long)romcalls);
+	for (i = 0; i < nsyms; i++) {
+		if (syms[i].calls == 0) continue;
+		printf("func,%s,%llu,%llu,%llu,%llu,%llu\n", syms[i].name, (unsigned long long)syms[i].calls,
+			(unsigned long long)syms[i].t, (unsigned long long)(syms[i].t / syms[i].calls),
+			(unsigned long long)syms[i].tmin, (unsigned long long)syms[i].tmax);
+	}
+	for (i = 0; i < 256; i++) if (romcode[i] != 0) printf("rom,$%02X,%llu\n", i, (unsigned long long)romcode[i]);
+	if (base != NULL && compare(base, pct) != 0) return 2;
+	return 0;
+}
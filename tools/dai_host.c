@@ -0,0 +1,684 @@
+//====================================================================================
+// dai_host : Linux build of the dai_* functions and of the example program
+//====================================================================================
+// Runs the demos of the example at host speed : the C sources of libdai are compiled
+// as they are, the ROM routines and the functions written in 8080 assembly are replaced
+// by C versions working on a DAI address space (dai_hmem). Screen memory is built with
+// the layout of the DAI (same stand-in as tools/dai_bench.c), so dai_vinit, dai_tinit and
+// all native functions run on it. The screen is then saved as an image and can be
+// compared with a golden image, ex: the PNG of the repository for mandelbrot.
+//
+// Build (Linux) : cc -O2 -o dai_host tools/dai_host.c
+// Options of the example or of libdai/dai.h are given with -D, ex: -DFX_XMAX=83 -DFX_YMAX=63,
+// -DMANDELBROT_FASTREJECT, -DMANDELBROT_KCACHE or -DDAI_BACKBUFFER (MANDELBROT_CHECKPOINT and
+// DAI_PROFILE use fixed RAM areas of the DAI and are not supported)
+// Usage : dai_host [options] function [out.png|out.ppm]
+// function : mandelbrot, mandelbrot_fx, mandelbrot_ms, test_graphics, test_texts, test_escape, test_shapes, test_fills,
+// test_sprites or main
+// -g golden.png : compare the screen with an image of the graphic area (any size)
+// -p permille : max different dots for the comparison (default 1 per thousand)
+// -t : print characters sent to the ROM on stderr
+// Exit code 0, 1 on error, 2 when the screen differs from the golden image
+//
+// Output (stdout), one CSV record per line :
+// run,<function>,<mode>,<xmax>,<ymax>,<milliseconds>
+// text,<line>,<characters>           (text lines which are not blank, top first)
+// cmp,<golden>,<dots>,<different dots>,<per thousand>
+// Example :
+// dai_host -g Fractale_Mandelbrot_UT_G800_Alt12.png mandelbrot m.png
+// (2 different dots, mandelbrot_fx and mandelbrot_ms about 1 per thousand with 4.12 fixed
+// point : -p 2 for them)
+
+#define DAI_HOST
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../libdai/dai.h"
+#include "dai_image.h"
+
+#if defined(MANDELBROT_CHECKPOINT) || defined(DAI_PROFILE)
+#error "dai_host : fixed RAM areas of the DAI are not supported"
+#endif
+
+
+//====================================================================================
+// Definitions
+//====================================================================================
+#define ROM_START 0xC000
+#define TEXT_COLS 60
+#define PALETTE_ADDR 0x0119 // colors of dai_colorg, read by dai_vpalette
+
+typedef struct {
+	const char *name;
+	void (*f)(void);
+} demo_t;
+
+
+//====================================================================================
+// Global variables
+//====================================================================================
+uint8_t dai_hmem[0x10000];
+
+// ROM stand-in
+static uint8_t vmode = 0xFF, v16;
+static uint16_t vxmax;
+static uint8_t vymax;
+static uint8_t *vrow[256]; // screen rows of the mode (dai_vrow may point to a back buffer)
+static uint8_t *trow[24]; // character of column 0 of each text line, line 0 at bottom
+static uint8_t tn, curx, cury, tcolor = 0xF0;
+static int echo;
+
+
+//====================================================================================
+// DAI ROM STAND-IN
+//====================================================================================
+
+// -----------------------------------------------------------------------------------
+// Screen memory : one line is mode byte, color byte, pairs of data bytes
+// -----------------------------------------------------------------------------------
+static uint8_t *vline(uint8_t *a, uint8_t mb, uint8_t cb, int pairs)
+{
+	a[0] = mb;
+	a[-1] = cb;
+	memset(a - 1 - 2 * pairs, 0, 2 * pairs);
+	return a - 2 - 2 * pairs;
+}
+
+// Text lines : character in the first byte of a pair, color in the second one
+static void tclear(uint8_t *r)
+{
+	int x;
+
+	for (x = 0; x < TEXT_COLS; x++) {
+		r[-2 * x] = ' ';
+		r[-2 * x - 1] = tcolor;
+	}
+}
+
+// m as dai_mode : bit 0 = A mode (4 text lines), bit 1 = 4 colors, m >> 2 = resolution
+static void vbuild(uint8_t m)
+{
+	static const int pairs[3] = {11, 22, 44};
+	static const int xmaxs[3] = {71, 159, 335};
+	static const int ymaxs[3] = {64, 129, 255};
+	static const int reps[3] = {3, 1, 0};
+	uint8_t *a = &dai_hmem[ROM_START - 1];
+	int res, scans, n, y, rep;
+
+	memset(&dai_hmem[0x4000], 0, ROM_START - 0x4000);
+	vmode = m;
+	tn = 0;
+	if (m == 0xFF || (m >> 2) > 2) {
+		vmode = 0xFF;
+		vxmax = 59;
+		vymax = 23;
+		scans = DAI_VSCANS - 24 * 20;
+		tn = 24;
+	} else {
+		res = m >> 2;
+		v16 = ((m & 0x02) == 0);
+		vxmax = xmaxs[res];
+		vymax = ymaxs[res];
+		if (m & 1) tn = 4;
+		scans = DAI_VSCANS - (vymax + 1) * 2 * (reps[res] + 1) - tn * 20;
+	}
+	while (scans > 0) { // unit color padding lines on top
+		rep = scans / 2 - 1;
+		if (rep > 15) rep = 15;
+		if (rep < 0) rep = 0;
+		a = vline(a, 0x30 | rep, 0x00, 66);
+		scans -= 2 * (rep + 1);
+	}
+	if (vmode != 0xFF) {
+		for (n = vymax; n >= 0; n--) { // graphic rows, top first
+			vrow[n] = a - 2;
+			a = vline(a, (v16 ? 0x80 : 0x00) | (res << 4) | reps[res], 0x40, pairs[res]);
+		}
+	}
+	for (y = tn - 1; y >= 0; y--) { // text lines
+		trow[y] = a - 2;
+		a = vline(a, 0x70 | 9, 0x40, 66);
+		tclear(trow[y]);
+	}
+	curx = 0;
+	cury = (tn ? tn - 1 : 0);
+}
+
+// Address of first byte of the pair of dot x in row y, mask of the dot
+static uint8_t *vpair(uint16_t x, uint8_t y, uint8_t *mk)
+{
+	x += 8; // unused pair on the left
+	*mk = 0x80 >> (x & 7);
+	return vrow[y] - ((x >> 3) << 1);
+}
+
+static uint8_t vscrn(uint16_t x, uint8_t y)
+{
+	uint8_t *p, mk;
+
+	if (vmode == 0xFF || x > vxmax || y > vymax) return 0;
+	p = vpair(x, y, &mk);
+	if (v16) return (p[0] & mk) ? p[-1] >> 4 : p[-1] & 0x0F;
+	return DAI_ADDR(PALETTE_ADDR)[((p[0] & mk) ? 1 : 0) | ((p[-1] & mk) ? 2 : 0)];
+}
+
+static void vdot(uint16_t x, uint8_t y, uint8_t c)
+{
+	uint8_t *p, mk, hi, lo;
+	int i;
+
+	if (vmode == 0xFF || x > vxmax || y > vymax) return;
+	c &= 0x0F;
+	p = vpair(x, y, &mk);
+	if (v16) { // set dots use the high nibble of the color byte
+		hi = p[-1] >> 4;
+		lo = p[-1] & 0x0F;
+		if (c == hi) p[0] |= mk;
+		else if (c == lo) p[0] &= ~mk;
+		else if ((p[0] | mk) == 0xFF) { // no other clear dot
+			p[-1] = (hi << 4) | c;
+			p[0] &= ~mk;
+		} else { // new color for set dots
+			p[-1] = (c << 4) | lo;
+			p[0] |= mk;
+		}
+		return;
+	}
+	for (i = 0; i < 4; i++) if (DAI_ADDR(PALETTE_ADDR)[i] == c) break;
+	if (i == 4) return; // not in palette
+	p[0] = (i & 1) ? p[0] | mk : p[0] & ~mk;
+	p[-1] = (i & 2) ? p[-1] | mk : p[-1] & ~mk;
+}
+
+static void vdraw(int x0, int y0, int x1, int y1, uint8_t c)
+{
+	int dx = abs(x1 - x0), dy = abs(y1 - y0), sx = x1 > x0 ? 1 : -1, sy = y1 > y0 ? 1 : -1;
+	int err = dx - dy, e2;
+
+	while (1) {
+		vdot(x0, y0, c);
+		if (x0 == x1 && y0 == y1) return;
+		e2 = 2 * err;
+		if (e2 > -dy) {
+			err -= dy;
+			x0 += sx;
+		}
+		if (e2 < dx) {
+			err += dx;
+			y0 += sy;
+		}
+	}
+}
+
+// New line, the text lines scroll up from the bottom one
+static void tnewline(void)
+{
+	int y;
+
+	curx = 0;
+	if (cury > 0) {
+		cury--;
+		return;
+	}
+	for (y = tn - 1; y > 0; y--) memcpy(trow[y] - 2 * TEXT_COLS + 1, trow[y - 1] - 2 * TEXT_COLS + 1, 2 * TEXT_COLS);
+	if (tn) tclear(trow[0]);
+}
+
+
+//====================================================================================
+// FUNCTIONS OF LIBDAI CALLING THE ROM
+//====================================================================================
+void dai_mode(uint8_t m)
+{
+	vbuild(m);
+	dai_vinit(m);
+}
+
+void dai_mode_fastcall(uint8_t m)
+{
+	dai_mode(m);
+}
+
+void dai_colorg(uint8_t C0, uint8_t C1, uint8_t C2, uint8_t C3)
+{
+	uint8_t *p = DAI_ADDR(PALETTE_ADDR);
+
+	p[0] = C0 & 0x0F;
+	p[1] = C1 & 0x0F;
+	p[2] = C2 & 0x0F;
+	p[3] = C3 & 0x0F;
+	dai_vpalette();
+}
+
+void dai_colorg_callee(uint8_t C0, uint8_t C1, uint8_t C2, uint8_t C3)
+{
+	dai_colorg(C0, C1, C2, C3);
+}
+
+void dai_dot(uint16_t x, uint8_t y, uint8_t c)
+{
+	vdot(x, y, c);
+}
+
+void dai_dot_callee(uint16_t x, uint8_t y, uint8_t c)
+{
+	vdot(x, y, c);
+}
+
+void dai_draw(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint8_t c)
+{
+	vdraw(x0, y0, x1, y1, c);
+}
+
+void dai_draw_callee(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint8_t c)
+{
+	vdraw(x0, y0, x1, y1, c);
+}
+
+void dai_fill(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint8_t c)
+{
+	int x, y;
+
+	if (x0 > x1) {
+		x = x0;
+		x0 = x1;
+		x1 = x;
+	}
+	if (y0 > y1) {
+		y = y0;
+		y0 = y1;
+		y1 = y;
+	}
+	for (y = y0; y <= y1; y++) for (x = x0; x <= x1; x++) vdot(x, y, c);
+}
+
+void dai_fill_callee(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint8_t c)
+{
+	dai_fill(x0, y0, x1, y1, c);
+}
+
+uint16_t dai_xmax(void)
+{
+	return (dai_vmode != 0xFF ? dai_vxmax : vxmax);
+}
+
+uint8_t dai_ymax(void)
+{
+	return (dai_vmode != 0xFF ? dai_vymax : vymax);
+}
+
+uint8_t dai_scrn(uint16_t x, uint8_t y)
+{
+	return vscrn(x, y);
+}
+
+uint8_t dai_scrn_callee(uint16_t x, uint8_t y)
+{
+	return vscrn(x, y);
+}
+
+void dai_colort(uint8_t C0, uint8_t C1, uint8_t C2, uint8_t C3)
+{
+	(void)C2;
+	(void)C3;
+	tcolor = ((C1 & 0x0F) << 4) | (C0 & 0x0F);
+	dai_tok = 0;
+	dai_ttried = 0;
+}
+
+void dai_colort_callee(uint8_t C0, uint8_t C1, uint8_t C2, uint8_t C3)
+{
+	dai_colort(C0, C1, C2, C3);
+}
+
+void dai_cursor(uint8_t x, uint8_t y)
+{
+	curx = (x < TEXT_COLS ? x : TEXT_COLS - 1);
+	cury = (y < tn ? y : (tn ? tn - 1 : 0));
+}
+
+void dai_cursor_callee(uint8_t x, uint8_t y)
+{
+	dai_cursor(x, y);
+}
+
+uint8_t dai_curx(void)
+{
+	return curx;
+}
+
+uint8_t dai_cury(void)
+{
+	return cury;
+}
+
+uint16_t dai_textmax(void)
+{
+	return ((tn ? tn - 1 : 0) << 8) | (TEXT_COLS - 1);
+}
+
+void dai_putchar(uint8_t c)
+{
+	int y;
+
+	if (echo) fputc(c == 0x0D ? '\n' : c, stderr);
+	if (c == 0x0C) { // clear screen
+		for (y = 0; y < tn; y++) tclear(trow[y]);
+		curx = 0;
+		cury = (tn ? tn - 1 : 0);
+	} else if ((c == 0x0D) | (c == 0x0A)) tnewline();
+	else if (c >= 0x20) {
+		if (tn) {
+			trow[cury][-2 * curx] = c;
+			trow[cury][-2 * curx - 1] = tcolor;
+		}
+		if (++curx == TEXT_COLS) tnewline();
+	}
+}
+
+void dai_clearscreen(void)
+{
+	dai_putchar(0x0C);
+}
+
+
+//====================================================================================
+// FUNCTIONS OF LIBDAI WRITTEN IN ASSEMBLY
+//====================================================================================
+// Same results as the 8080 code, dai_vdot_reg has no C version (registers interface)
+
+void dai_vdot(uint16_t x, uint8_t y, uint8_t c)
+{
+	uint8_t *p, mk, d, idx;
+
+#ifdef DAI_BACKBUFFER
+	if (dai_bbact) dai_bbdirty(x, y, x, y);
+#endif
+	if ((dai_vok == 0) | (y > dai_vymax) | (x > dai_vxmax) || ((dai_vrow[y][1] & 0x40) == 0) | (c > 0x0F)) {
+		dai_dot(x, y, c);
+		return;
+	}
+	x += 8; // unused pair on the left
+	p = dai_vrow[y] - ((x >> 3) << 1);
+	mk = dai_vmask[x & 7];
+	if (dai_v16) {
+		d = p[-1];
+		if (dai_vhi) d = (d >> 4) | (d << 4); // color of set dots in low nibble
+		if ((d & 0x0F) == c) p[0] |= mk;
+		else if ((d >> 4) == c) p[0] &= ~mk;
+		else dai_dot(x - 8, y, c);
+		return;
+	}
+	idx = dai_vidx[c];
+	if (idx == 0xFF) {
+		dai_dot(x - 8, y, c);
+		return;
+	}
+	p[0] = (idx & 1) ? p[0] | mk : p[0] & ~mk;
+	p[-1] = (idx & 2) ? p[-1] | mk : p[-1] & ~mk;
+}
+
+void dai_vdot_callee(uint16_t x, uint8_t y, uint8_t c)
+{
+	dai_vdot(x, y, c);
+}
+
+uint16_t dai_vspan4(uint8_t *row, uint16_t x, uint16_t n, uint8_t *buf)
+{
+	uint8_t *p, mk, idx;
+
+	x += 8;
+	for ( ; n != 0; n--, x++) {
+		idx = dai_vidx[*buf++ & 0x0F];
+		if (idx == 0xFF) return n;
+		p = row - ((x >> 3) << 1);
+		mk = dai_vmask[x & 7];
+		p[0] = (idx & 1) ? p[0] | mk : p[0] & ~mk;
+		p[-1] = (idx & 2) ? p[-1] | mk : p[-1] & ~mk;
+	}
+	return 0;
+}
+
+void dai_vbytes(uint8_t *p, uint16_t n, uint8_t pt0, uint8_t pt1)
+{
+	for ( ; n != 0; n--) {
+		p[0] = pt0;
+		p[-1] = pt1;
+		p -= 2;
+	}
+}
+
+void dai_vcopy(uint8_t *dst, uint8_t *src, uint16_t n)
+{
+	for ( ; n != 0; n--) *dst-- = *src--;
+}
+
+uint8_t *dai_vblit4(uint8_t *p, uint8_t *s, uint8_t n)
+{
+	for ( ; n != 0; n--, s += 3, p -= 2) {
+		p[0] = (p[0] & ~s[0]) | s[1];
+		p[-1] = (p[-1] & ~s[0]) | s[2];
+	}
+	return s;
+}
+
+uint8_t *dai_vunrow(uint8_t *src, uint8_t *dst, uint16_t delta, uint8_t n)
+{
+	uint8_t t, k;
+
+	while (n != 0) {
+		t = *src++;
+		if (t & 0x80) { // pairs of the row below
+			for (k = (t & 0x7F) + 1, n -= k; k != 0; k--, dst -= 2) {
+				dst[0] = dst[(int16_t)delta];
+				dst[-1] = dst[(int16_t)delta - 1];
+			}
+		} else if (t & 0x40) { // next pair repeated
+			for (k = (t & 0x3F) + 1, n -= k; k != 0; k--, dst -= 2) {
+				dst[0] = src[0];
+				dst[-1] = src[1];
+			}
+			src += 2;
+		} else { // pairs follow
+			for (k = t + 1, n -= k; k != 0; k--, dst -= 2, src += 2) {
+				dst[0] = src[0];
+				dst[-1] = src[1];
+			}
+		}
+	}
+	return src;
+}
+
+
+//====================================================================================
+// SOURCES OF LIBDAI (C)
+//====================================================================================
+#include "../libdai/dai_vars.c"
+#include "../libdai/dai_vinit.c"
+#include "../libdai/dai_vpalette.c"
+#include "../libdai/dai_vget.c"
+#include "../libdai/dai_vscrn.c"
+#include "../libdai/dai_dots.c"
+#include "../libdai/dai_vdraw.c"
+#include "../libdai/dai_vfill.c"
+#include "../libdai/dai_vclear.c"
+#include "../libdai/dai_vhspan4.c"
+#include "../libdai/dai_vput4.c"
+#include "../libdai/dai_vunpack.c"
+#include "../libdai/dai_vcdot.c"
+#include "../libdai/dai_vcspan.c"
+#include "../libdai/dai_arc.c"
+#include "../libdai/dai_circle.c"
+#include "../libdai/dai_circlefill.c"
+#include "../libdai/dai_vellipse.c"
+#include "../libdai/dai_ellipse.c"
+#include "../libdai/dai_ellipsefill.c"
+#include "../libdai/dai_fill_polygon.c"
+#include "../libdai/dai_flood_fill.c"
+#include "../libdai/dai_sprmake.c"
+#include "../libdai/dai_blit.c"
+#include "../libdai/dai_unblit.c"
+#include "../libdai/dai_tinit.c"
+#include "../libdai/dai_puts.c"
+#include "../libdai/dai_print_uint.c"
+#ifdef DAI_BACKBUFFER
+#include "../libdai/dai_bbon.c"
+#include "../libdai/dai_bbflush.c"
+#include "../libdai/dai_bboff.c"
+#include "../libdai/dai_bbdirty.c"
+#endif
+
+
+//====================================================================================
+// MAIN
+//====================================================================================
+void mandelbrot(void) __attribute__((weak)); // only with MANDELBROT_DOUBLE
+void mandelbrot_fx(void);
+void mandelbrot_ms(void);
+void test_graphics(void);
+void test_texts(void);
+void test_escape(void);
+void test_shapes(void);
+void test_fills(void);
+void test_sprites(void);
+void dai_example_main();
+
+static int getk(void) // keyboard of the example, no key pressed
+{
+	return 0;
+}
+
+// Dots of the screen as RGB, first line at the top
+static uint8_t *screen_rgb(void)
+{
+	uint8_t *rgb = malloc((size_t)(vxmax + 1) * (vymax + 1) * 3);
+	int x, y;
+
+	if (rgb == NULL) return NULL;
+	for (y = 0; y <= vymax; y++)
+		for (x = 0; x <= vxmax; x++) memcpy(&rgb[((vymax - y) * (vxmax + 1) + x) * 3], dai_rgb[vscrn(x, y)], 3);
+	return rgb;
+}
+
+static int ppm_write(const char *name, const uint8_t *rgb, int w, int h)
+{
+	FILE *f = fopen(name, "wb");
+	int ok;
+
+	if (f == NULL) return 0;
+	fprintf(f, "P6\n%d %d\n255\n", w, h);
+	ok = (fwrite(rgb, 3, (size_t)w * h, f) == (size_t)w * h);
+	return (fclose(f) == 0) & ok;
+}
+
+// Different dots from a golden image, -1 if it can not be read
+// The golden image is a resized screenshot : a dot matches when its color is the one of
+// any pixel covered by the dot (pixels take the nearest color of the mode)
+static long compare(const char *name, long *dots)
+{
+	static const uint8_t all[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+	const uint8_t *colors = (v16 ? all : DAI_ADDR(PALETTE_ADDR));
+	uint8_t *rgb, c;
+	int w, h, x, y, gx, gy, ok;
+	long n = 0;
+
+	rgb = png_read(name, &w, &h);
+	if (rgb == NULL) return -1;
+	for (y = 0; y <= vymax; y++) {
+		for (x = 0; x <= vxmax; x++) {
+			c = vscrn(x, y);
+			ok = 0;
+			for (gy = (long)(vymax - y) * h / (vymax + 1); !ok && gy < (long)(vymax - y + 1) * h / (vymax + 1); gy++)
+				for (gx = (long)x * w / (vxmax + 1); !ok && gx < (long)(x + 1) * w / (vxmax + 1); gx++)
+					ok = (colors[dai_nearest(&rgb[((long)gy * w + gx) * 3], colors, v16 ? 16 : 4)] == c);
+			if (!ok) n++;
+		}
+	}
+	free(rgb);
+	*dots = (long)(vxmax + 1) * (vymax + 1);
+	return n;
+}
+
+int dai_host_main(int argc, char **argv)
+{
+	static const demo_t demos[] = {
+		{"mandelbrot", mandelbrot}, {"mandelbrot_fx", mandelbrot_fx}, {"mandelbrot_ms", mandelbrot_ms},
+		{"test_graphics", test_graphics}, {"test_texts", test_texts}, {"test_escape", test_escape},
+		{"test_shapes", test_shapes}, {"test_fills", test_fills}, {"test_sprites", test_sprites},
+		{"main", dai_example_main}
+	};
+	const char *golden = NULL, *out = NULL, *s;
+	uint8_t *rgb, *r;
+	int permille = 1, i, d, x, y, ok;
+	long n, dots;
+	struct timespec t0, t1;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) golden = argv[++i];
+		else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) permille = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-t") == 0) echo = 1;
+		else break;
+	}
+	d = -1;
+	if (i < argc) for (d = (int)(sizeof(demos) / sizeof(demos[0])) - 1; d >= 0; d--) if (strcmp(argv[i], demos[d].name) == 0) break;
+	if (i + 1 < argc) out = argv[i + 1];
+	if (d < 0 || argc - i > 2 || demos[d].f == NULL) {
+		fprintf(stderr, "usage: dai_host [-g golden.png] [-p permille] [-t] function [out.png|out.ppm]\n");
+		fprintf(stderr, "function : mandelbrot (with MANDELBROT_DOUBLE), mandelbrot_fx, mandelbrot_ms, test_graphics, test_texts, test_escape, test_shapes, test_fills, test_sprites, main\n");
+		return 1;
+	}
+	vbuild(0xFF);
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	demos[d].f();
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	if (echo) fputc('\n', stderr);
+	printf("run,%s,%02X,%u,%u,%ld\n", demos[d].name, vmode, vxmax, vymax,
+		(long)((t1.tv_sec - t0.tv_sec) * 1000 + (t1.tv_nsec - t0.tv_nsec) / 1000000));
+	for (y = tn - 1; y >= 0; y--) {
+		r = trow[y];
+		for (x = TEXT_COLS; x > 0 && r[-2 * (x - 1)] == ' '; x--);
+		if (x == 0) continue;
+		printf("text,%d,", tn - 1 - y);
+		for (i = 0; i < x; i++) putchar(r[-2 * i]);
+		putchar('\n');
+	}
+	if (vmode == 0xFF) {
+		if (out != NULL || golden != NULL) fprintf(stderr, "dai_host: text mode, no graphic screen\n");
+		return (out != NULL || golden != NULL);
+	}
+	if (out != NULL) {
+		rgb = screen_rgb();
+		s = strrchr(out, '.');
+		ok = (rgb != NULL) && (s != NULL && strcmp(s, ".ppm") == 0 ? ppm_write(out, rgb, vxmax + 1, vymax + 1) : png_write(out, rgb, vxmax + 1, vymax + 1));
+		free(rgb);
+		if (!ok) {
+			fprintf(stderr, "dai_host: cannot write %s\n", out);
+			return 1;
+		}
+	}
+	if (golden != NULL) {
+		n = compare(golden, &dots);
+		if (n < 0) {
+			fprintf(stderr, "dai_host: cannot read %s\n", golden);
+			return 1;
+		}
+		printf("cmp,%s,%ld,%ld,%ld\n", golden, dots, n, n * 1000 / dots);
+		if (n * 1000 > (long)permille * dots) return 2;
+	}
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	return dai_host_main(argc, argv);
+}
+
+
+//====================================================================================
+// EXAMPLE PROGRAM
+//====================================================================================
+#define main dai_example_main // run with function main
+#include "../DAI C graphical interfaces and example.c"
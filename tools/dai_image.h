@@ -0,0 +1,420 @@
+//====================================================================================
+// dai_image.h : DAI colors, PNG read and write for the host tools
+//====================================================================================
+// Static functions, included by the tools which read or write PNG files, no library
+// needed (inflate is built in, written files use stored deflate blocks).
+// png_read : 8 bits gray, RGB, palette, gray alpha or RGBA, not interlaced, alpha ignored.
+// Images are RGB, 3 bytes per dot, first line at the top.
+
+#ifndef DAI_IMAGE_H
+#define DAI_IMAGE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//====================================================================================
+// Definitions
+//====================================================================================
+typedef struct {
+	const uint8_t *in;
+	size_t inlen, inpos;
+	uint32_t bitbuf;
+	int bitcnt, err;
+	uint8_t *out;
+	size_t outlen, outpos;
+} png_inf_t;
+
+typedef struct {
+	short count[16], symbol[288];
+} png_huff_t;
+
+
+//====================================================================================
+// Global variables
+//====================================================================================
+// RGB of the 16 DAI colors (as in the MAME DAI driver and the PNG of the repository)
+static const uint8_t dai_rgb[16][3] = {
+	{0x00, 0x00, 0x00}, {0x00, 0x00, 0x8B}, {0xB1, 0x00, 0x95}, {0xFF, 0x00, 0x00},
+	{0x75, 0x2E, 0x50}, {0x00, 0xB2, 0x38}, {0x98, 0x62, 0x00}, {0xAE, 0x7A, 0x00},
+	{0x89, 0x89, 0x89}, {0xA1, 0x6F, 0xFF}, {0xFF, 0xA5, 0x00}, {0xFF, 0x99, 0xFF},
+	{0x9E, 0xF4, 0xFF}, {0xB3, 0xFF, 0xBB}, {0xFF, 0xFF, 0x28}, {0xFF, 0xFF, 0xFF}
+};
+
+
+//====================================================================================
+// FUNCTIONS
+//====================================================================================
+
+// -----------------------------------------------------------------------------------
+// Colors
+// -----------------------------------------------------------------------------------
+// Index in colors[0..n-1] of the DAI color nearest to an RGB dot
+static int dai_nearest(const uint8_t *rgb, const uint8_t *colors, int n)
+{
+	long d, best = -1;
+	int i, r = 0, e;
+
+	for (i = 0; i < n; i++) {
+		e = rgb[0] - dai_rgb[colors[i]][0];
+		d = (long)e * e;
+		e = rgb[1] - dai_rgb[colors[i]][1];
+		d += (long)e * e;
+		e = rgb[2] - dai_rgb[colors[i]][2];
+		d += (long)e * e;
+		if (best < 0 || d < best) {
+			best = d;
+			r = i;
+		}
+	}
+	return r;
+}
+
+
+// -----------------------------------------------------------------------------------
+// Inflate (RFC 1951)
+// -----------------------------------------------------------------------------------
+static int png_bits(png_inf_t *s, int need)
+{
+	uint32_t v = s->bitbuf;
+
+	while (s->bitcnt < need) {
+		if (s->inpos == s->inlen) {
+			s->err = 1;
+			return 0;
+		}
+		v |= (uint32_t)s->in[s->inpos++] << s->bitcnt;
+		s->bitcnt += 8;
+	}
+	s->bitbuf = v >> need;
+	s->bitcnt -= need;
+	return v & ((1u << need) - 1);
+}
+
+static void png_huff(png_huff_t *h, const short *length, int n)
+{
+	short offs[16];
+	int sym, len;
+
+	memset(h->count, 0, sizeof(h->count));
+	for (sym = 0; sym < n; sym++) h->count[length[sym]]++;
+	offs[1] = 0;
+	for (len = 1; len < 15; len++) offs[len + 1] = offs[len] + h->count[len];
+	for (sym = 0; sym < n; sym++) if (length[sym] != 0) h->symbol[offs[length[sym]]++] = sym;
+}
+
+static int png_decode(png_inf_t *s, const png_huff_t *h)
+{
+	int code = 0, first = 0, index = 0, len, count;
+
+	for (len = 1; len < 16; len++) {
+		code |= png_bits(s, 1);
+		count = h->count[len];
+		if (code - count < first) return h->symbol[index + (code - first)];
+		index += count;
+		first = (first + count) << 1;
+		code <<= 1;
+	}
+	s->err = 1;
+	return 256;
+}
+
+static void png_codes(png_inf_t *s, const png_huff_t *lc, const png_huff_t *dc)
+{
+	static const short lbase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+		35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+	static const short lext[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+		3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+	static const short dbase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+		257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+	static const short dext[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+		7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+	int sym, len;
+	size_t dist;
+
+	while (!s->err) {
+		sym = png_decode(s, lc);
+		if (sym < 256) {
+			if (s->outpos == s->outlen) break;
+			s->out[s->outpos++] = sym;
+			continue;
+		}
+		if (sym == 256) return;
+		sym -= 257;
+		if (sym >= 29) break;
+		len = lbase[sym] + png_bits(s, lext[sym]);
+		sym = png_decode(s, dc);
+		if (sym >= 30) break;
+		dist = dbase[sym] + png_bits(s, dext[sym]);
+		if (dist > s->outpos || s->outpos + len > s->outlen) break;
+		for (; len > 0; len--, s->outpos++) s->out[s->outpos] = s->out[s->outpos - dist];
+	}
+	s->err = 1;
+}
+
+// zlib stream in[0..inlen-1] to out[0..outlen-1], returns bytes written, 0 on error
+static size_t png_inflate(const uint8_t *in, size_t inlen, uint8_t *out, size_t outlen)
+{
+	static const uint8_t order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+	png_inf_t s;
+	png_huff_t lc, dc;
+	short lengths[320];
+	int last, type, nlen, ndist, ncode, i, sym, rep, len;
+	unsigned n;
+
+	if (inlen < 2 || (in[0] & 0x0F) != 8) return 0;
+	memset(&s, 0, sizeof(s));
+	s.in = in;
+	s.inlen = inlen;
+	s.inpos = 2;
+	s.out = out;
+	s.outlen = outlen;
+	do {
+		last = png_bits(&s, 1);
+		type = png_bits(&s, 2);
+		if (type == 0) { // stored
+			s.bitbuf = 0;
+			s.bitcnt = 0;
+			if (s.inpos + 4 > inlen) return 0;
+			n = in[s.inpos] | (in[s.inpos + 1] << 8);
+			s.inpos += 4;
+			if (s.inpos + n > inlen || s.outpos + n > outlen) return 0;
+			memcpy(&out[s.outpos], &in[s.inpos], n);
+			s.inpos += n;
+			s.outpos += n;
+		} else if (type == 1) { // fixed codes
+			for (i = 0; i < 144; i++) lengths[i] = 8;
+			for (; i < 256; i++) lengths[i] = 9;
+			for (; i < 280; i++) lengths[i] = 7;
+			for (; i < 288; i++) lengths[i] = 8;
+			png_huff(&lc, lengths, 288);
+			for (i = 0; i < 30; i++) lengths[i] = 5;
+			png_huff(&dc, lengths, 30);
+			png_codes(&s, &lc, &dc);
+		} else if (type == 2) { // dynamic codes
+			nlen = png_bits(&s, 5) + 257;
+			ndist = png_bits(&s, 5) + 1;
+			ncode = png_bits(&s, 4) + 4;
+			memset(lengths, 0, sizeof(lengths));
+			for (i = 0; i < ncode; i++) lengths[order[i]] = png_bits(&s, 3);
+			png_huff(&lc, lengths, 19);
+			for (i = 0; i < nlen + ndist && !s.err;) {
+				sym = png_decode(&s, &lc);
+				if (sym < 16) {
+					lengths[i++] = sym;
+					continue;
+				}
+				len = 0;
+				if (sym == 16) {
+					if (i == 0) return 0;
+					len = lengths[i - 1];
+					rep = 3 + png_bits(&s, 2);
+				} else if (sym == 17) rep = 3 + png_bits(&s, 3);
+				else rep = 11 + png_bits(&s, 7);
+				if (i + rep > nlen + ndist) return 0;
+				while (rep-- > 0) lengths[i++] = len;
+			}
+			png_huff(&lc, lengths, nlen);
+			png_huff(&dc, lengths + nlen, ndist);
+			png_codes(&s, &lc, &dc);
+		} else return 0;
+		if (s.err) return 0;
+	} while (!last);
+	return s.outpos;
+}
+
+
+// -----------------------------------------------------------------------------------
+// PNG files
+// -----------------------------------------------------------------------------------
+static uint32_t png_crc(uint32_t c, const uint8_t *p, size_t n)
+{
+	static uint32_t table[256];
+	uint32_t v;
+	int i, k;
+
+	if (table[1] == 0) {
+		for (i = 0; i < 256; i++) {
+			v = i;
+			for (k = 0; k < 8; k++) v = (v & 1) ? 0xEDB88320u ^ (v >> 1) : v >> 1;
+			table[i] = v;
+		}
+	}
+	c = ~c;
+	while (n-- > 0) c = table[(c ^ *p++) & 0xFF] ^ (c >> 8);
+	return ~c;
+}
+
+static uint32_t png_get32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+static void png_put32(uint8_t *p, uint32_t v)
+{
+	p[0] = v >> 24;
+	p[1] = v >> 16;
+	p[2] = v >> 8;
+	p[3] = v;
+}
+
+static int png_paeth(int a, int b, int c)
+{
+	int p = a + b - c, pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+
+	if (pa <= pb && pa <= pc) return a;
+	return pb <= pc ? b : c;
+}
+
+// RGB image of a PNG file, NULL on error
+static uint8_t *png_read(const char *name, int *w, int *h)
+{
+	static const uint8_t sig[8] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+	static const int chans[7] = {1, 0, 3, 1, 2, 0, 4};
+	uint8_t *file = NULL, *z = NULL, *raw = NULL, *rgb = NULL, *p, *line, *prev, pal[768];
+	size_t size, nz = 0, stride, i;
+	uint32_t len;
+	int type = -1, bpp = 0, x, y, a, b, c, v;
+	FILE *f = fopen(name, "rb");
+
+	memset(pal, 0, sizeof(pal));
+	if (f == NULL) return NULL;
+	fseek(f, 0, SEEK_END);
+	size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	file = malloc(size);
+	if (file == NULL || fread(file, 1, size, f) != size || size < 8 || memcmp(file, sig, 8) != 0) goto end;
+	z = malloc(size);
+	if (z == NULL) goto end;
+	*w = *h = 0;
+	for (p = file + 8; p + 12 <= file + size; p += 12 + len) {
+		len = png_get32(p);
+		if (len > (size_t)(file + size - p) - 12) goto end;
+		if (memcmp(p + 4, "IHDR", 4) == 0 && len >= 13) {
+			*w = png_get32(p + 8);
+			*h = png_get32(p + 12);
+			type = p[17];
+			if (p[16] != 8 || p[20] != 0 || type > 6 || chans[type] == 0) goto end;
+			bpp = chans[type];
+		} else if (memcmp(p + 4, "PLTE", 4) == 0) memcpy(pal, p + 8, len < 768 ? len : 768);
+		else if (memcmp(p + 4, "IDAT", 4) == 0) {
+			memcpy(z + nz, p + 8, len);
+			nz += len;
+		} else if (memcmp(p + 4, "IEND", 4) == 0) break;
+	}
+	if (bpp == 0 || *w <= 0 || *h <= 0 || *w > 16384 || *h > 16384) goto end;
+	stride = (size_t)*w * bpp;
+	raw = malloc((stride + 1) * *h);
+	rgb = malloc((size_t)*w * *h * 3);
+	if (raw == NULL || rgb == NULL || png_inflate(z, nz, raw, (stride + 1) * *h) != (stride + 1) * *h) {
+		free(rgb);
+		rgb = NULL;
+		goto end;
+	}
+
+	// Filters, then RGB
+	prev = NULL;
+	for (y = 0; y < *h; y++) {
+		line = raw + y * (stride + 1) + 1;
+		for (i = 0; i < stride; i++) {
+			a = i >= (size_t)bpp ? line[i - bpp] : 0;
+			b = prev != NULL ? prev[i] : 0;
+			c = (prev != NULL && i >= (size_t)bpp) ? prev[i - bpp] : 0;
+			switch (line[-1]) {
+			case 1: line[i] += a; break;
+			case 2: line[i] += b; break;
+			case 3: line[i] += (a + b) / 2; break;
+			case 4: line[i] += png_paeth(a, b, c); break;
+			}
+		}
+		for (x = 0; x < *w; x++) {
+			p = rgb + ((size_t)y * *w + x) * 3;
+			v = line[x * bpp];
+			if (type == 3) memcpy(p, &pal[v * 3], 3);
+			else if (type >= 2 && type != 4) memcpy(p, &line[x * bpp], 3);
+			else p[0] = p[1] = p[2] = v;
+		}
+		prev = line;
+	}
+end:
+	fclose(f);
+	free(file);
+	free(z);
+	free(raw);
+	return rgb;
+}
+
+static int png_chunk(FILE *f, const char *type, const uint8_t *p, size_t n)
+{
+	uint8_t b[8];
+	uint32_t c;
+
+	png_put32(b, n);
+	memcpy(b + 4, type, 4);
+	c = png_crc(png_crc(0, b + 4, 4), p, n);
+	if (fwrite(b, 1, 8, f) != 8 || (n != 0 && fwrite(p, 1, n, f) != n)) return 0;
+	png_put32(b, c);
+	return fwrite(b, 1, 4, f) == 4;
+}
+
+// RGB image to a PNG file (stored deflate blocks), returns 0 on error
+static int png_write(const char *name, const uint8_t *rgb, int w, int h)
+{
+	size_t stride = (size_t)w * 3 + 1, nraw = stride * h, nz, i, n;
+	uint8_t *raw, *z, *q, hdr[13];
+	uint32_t s1 = 1, s2 = 0;
+	int y, ok;
+	FILE *f;
+
+	raw = malloc(nraw);
+	z = malloc(nraw + nraw / 65535 * 5 + 16);
+	if (raw == NULL || z == NULL) {
+		free(raw);
+		free(z);
+		return 0;
+	}
+	for (y = 0; y < h; y++) {
+		raw[y * stride] = 0;
+		memcpy(&raw[y * stride + 1], &rgb[(size_t)y * w * 3], w * 3);
+	}
+	q = z;
+	*q++ = 0x78;
+	*q++ = 0x01;
+	for (i = 0; i < nraw; i += n) {
+		n = nraw - i < 65535 ? nraw - i : 65535;
+		*q++ = (i + n == nraw);
+		*q++ = n & 0xFF;
+		*q++ = n >> 8;
+		*q++ = ~n & 0xFF;
+		*q++ = (~n >> 8) & 0xFF;
+		memcpy(q, &raw[i], n);
+		q += n;
+	}
+	for (i = 0; i < nraw; i++) {
+		s1 = (s1 + raw[i]) % 65521;
+		s2 = (s2 + s1) % 65521;
+	}
+	png_put32(q, (s2 << 16) | s1);
+	q += 4;
+	nz = q - z;
+
+	png_put32(hdr, w);
+	png_put32(hdr + 4, h);
+	hdr[8] = 8; // depth
+	hdr[9] = 2; // RGB
+	hdr[10] = hdr[11] = hdr[12] = 0;
+	f = fopen(name, "wb");
+	ok = f != NULL;
+	if (ok) {
+		fwrite("\x89PNG\r\n\x1A\n", 1, 8, f);
+		ok = png_chunk(f, "IHDR", hdr, 13) && png_chunk(f, "IDAT", z, nz) && png_chunk(f, "IEND", NULL, 0);
+		ok = (fclose(f) == 0) && ok;
+	}
+	free(raw);
+	free(z);
+	return ok;
+}
+
+#endif
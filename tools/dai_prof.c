@@ -0,0 +1,172 @@
+//====================================================================================
+// dai_prof : host report of the DAI profiling area (DAI_PROFILE)
+//====================================================================================
+// Reads a dump of the profiling area written by prof_isr and the probes, maps the
+// bins of the program counter histogram to the C functions of the z88dk .map file.
+//
+// Build (Linux) : cc -O2 -o dai_prof tools/dai_prof.c
+// Usage : dai_prof [-n names] prof.bin a.map
+// -n names : names of the probes, separated by commas (ex: -n iter,plot,border,fill)
+// prof.bin : bytes from PROF_AREA ($3000), 1040 + 8 * PROF_PROBES bytes or more
+// (DAI utility W3000 342F to tape, or from MAME debugger : save prof.bin,3000,430)
+//
+// Output (stdout), one CSV record per line, functions by decreasing samples :
+// samples,<total>,<out of bins>,<lo>,<bin size>
+// func,<symbol>,<samples>,<per thousand>
+// probe,<name>,<calls>,<samples>,<per thousand>
+// A bin covering two functions is given to the one at its start : use a lower shift
+// in prof_start for a finer split.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//====================================================================================
+// Definitions
+//====================================================================================
+#define AREA_SIZE 1040 // header and bins, probes follow
+#define MAX_SYMS 4096
+#define MAX_PROBES 64
+
+typedef struct {
+	char name[128];
+	uint16_t addr;
+	uint64_t samples;
+} sym_t;
+
+
+//====================================================================================
+// Global variables
+//====================================================================================
+static uint8_t area[AREA_SIZE + 8 * MAX_PROBES];
+static sym_t syms[MAX_SYMS];
+static int nsyms;
+
+
+//====================================================================================
+// FUNCTIONS
+//====================================================================================
+
+static uint32_t get32(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int by_addr(const void *a, const void *b)
+{
+	return ((const sym_t *)a)->addr - ((const sym_t *)b)->addr;
+}
+
+static int by_samples(const void *a, const void *b)
+{
+	const sym_t *x = a, *y = b;
+
+	if (x->samples != y->samples) return x->samples < y->samples ? 1 : -1;
+	return x->addr - y->addr;
+}
+
+static int load_map(const char *name)
+{
+	FILE *f = fopen(name, "r");
+	char line[512], sym[128];
+	unsigned addr;
+
+	if (f == NULL) return 0;
+	while (fgets(line, sizeof(line), f)) {
+		if (sscanf(line, " %127s = $%x", sym, &addr) != 2) continue;
+		if (sym[0] != '_' || sym[1] == '_' || strstr(line, "const") != NULL) continue;
+		if (nsyms == MAX_SYMS) break;
+		snprintf(syms[nsyms].name, sizeof(syms[nsyms].name), "%s", sym);
+		syms[nsyms].addr = addr;
+		nsyms++;
+	}
+	fclose(f);
+	qsort(syms, nsyms, sizeof(sym_t), by_addr);
+	return 1;
+}
+
+// Last symbol at or below addr, -1 if none
+static int find_addr(uint32_t addr)
+{
+	int lo = 0, hi = nsyms - 1, m, r = -1;
+
+	while (lo <= hi) {
+		m = (lo + hi) / 2;
+		if (syms[m].addr <= addr) {
+			r = m;
+			lo = m + 1;
+		} else hi = m - 1;
+	}
+	return r;
+}
+
+int main(int argc, char **argv)
+{
+	const char *names = NULL, *p;
+	uint32_t total, out, lo, size, n, calls, ticks;
+	int shift, probes, i, s, len;
+	size_t got;
+	FILE *f;
+
+	i = 1;
+	if (argc > 2 && strcmp(argv[1], "-n") == 0) {
+		names = argv[2];
+		i = 3;
+	}
+	if (argc - i != 2) {
+		fprintf(stderr, "usage: dai_prof [-n names] prof.bin a.map\n");
+		return 1;
+	}
+	f = fopen(argv[i], "rb");
+	if (f == NULL) {
+		fprintf(stderr, "dai_prof: cannot read %s\n", argv[i]);
+		return 1;
+	}
+	got = fread(area, 1, sizeof(area), f);
+	fclose(f);
+	if (got < AREA_SIZE || area[0] != 'P' || area[1] != 'F') {
+		fprintf(stderr, "dai_prof: %s is not a profiling area\n", argv[i]);
+		return 1;
+	}
+	if (!load_map(argv[i + 1])) {
+		fprintf(stderr, "dai_prof: cannot read %s\n", argv[i + 1]);
+		return 1;
+	}
+	lo = area[2] | (area[3] << 8);
+	shift = area[4];
+	probes = area[5];
+	total = get32(&area[8]);
+	out = get32(&area[12]);
+	size = 1u << shift;
+	printf("samples,%u,%u,$%04X,%u\n", total, out, lo, size);
+
+	// Bins to functions
+	for (i = 0; i < 256; i++) {
+		n = get32(&area[16 + 4 * i]);
+		if (n == 0) continue;
+		s = find_addr(lo + i * size);
+		if (s >= 0) syms[s].samples += n;
+		else printf("func,$%04X,%u,%u\n", lo + i * size, n, total ? (unsigned)(n * 1000ULL / total) : 0);
+	}
+	qsort(syms, nsyms, sizeof(sym_t), by_samples);
+	for (i = 0; i < nsyms && syms[i].samples != 0; i++)
+		printf("func,%s,%llu,%u\n", syms[i].name, (unsigned long long)syms[i].samples,
+			total ? (unsigned)(syms[i].samples * 1000ULL / total) : 0);
+
+	// Probes : calls, then samples
+	if (probes > MAX_PROBES || got < (size_t)(AREA_SIZE + 8 * probes)) probes = 0;
+	p = names;
+	for (i = 0; i < probes; i++) {
+		calls = get32(&area[AREA_SIZE + 4 * i]);
+		ticks = get32(&area[AREA_SIZE + 4 * (probes + i)]);
+		if (p != NULL && *p != '\0') {
+			len = strcspn(p, ",");
+			printf("probe,%.*s,", len, p);
+			p += len + (p[len] == ',');
+		} else printf("probe,%d,", i);
+		printf("%u,%u,%u\n", calls, ticks, total ? (unsigned)(ticks * 1000ULL / total) : 0);
+	}
+	return 0;
+}
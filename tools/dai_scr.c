@@ -0,0 +1,358 @@
+//====================================================================================
+// dai_scr : host encoder of DAI screen images shown by dai_vunpack
+//====================================================================================
+// Packs a PNG file or a dump of the DAI screen memory as an image for dai_vunpack,
+// which unpacks it directly in screen memory (format in libdai/dai_vunpack.c).
+// Rows are packed as runs of pairs, repeated pairs and pairs copied from the row below.
+//
+// Build (Linux) : cc -O2 -o dai_scr tools/dai_scr.c
+// Usage : dai_scr [options] in.png out.dsc    from a PNG (any size, resampled)
+//         dai_scr [options] in.bin out.dsc    from screen memory, in.bin ends at $BFFF
+//         dai_scr -x in.dsc out.png           image as the DAI shows it, one pixel per dot
+// -m mode : dai_mode of the image in hex (default 0A), as in dai_bench : bit 0 = A mode,
+//           bit 1 = 4 colors, mode >> 2 = resolution (72x65, 160x130, 336x256)
+// -p c0,c1,c2,c3 : colors of 4 colors modes (default : the 4 colors most used in the PNG,
+//           0,5,10,15 for screen memory as after a reset)
+// Exit code 0, 1 on error
+//
+// Output (stdout) : scr,<file>,<mode>,<xmax>,<ymax>,<screen bytes>,<image bytes>
+//
+// PNG : each dot takes the DAI color nearest to the pixel at its center. In 4 colors
+// modes dots then take the nearest of the 4 colors, in 16 colors modes each group of
+// 8 dots keeps its 2 most used colors.
+// Screen memory (ex: MAME debugger, save scr.bin,6000,6000) : graphic lines of the mode
+// are collected from $BFFF like dai_vinit, the last ymax + 1 of them are the rows.
+// Unit color lines take the color in the low nibble of their color byte, 16 colors
+// pairs are read with the high nibble for dots set in the first byte.
+// Load the image on the DAI, ex: dai_tape -a 4000 img.dsc img.wav, then UT R, and
+// show it with dai_vunpack((uint8_t *)0x4000).
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dai_image.h"
+
+
+//====================================================================================
+// Definitions
+//====================================================================================
+#define MODE_DEFAULT 0x0A // Mode 6, 336x256 4 colors
+#define ROM_START 0xC000
+#define MAX_X 528
+#define MAX_Y 256
+#define MAX_PAIRS (MAX_X / 8)
+#define HDR_SIZE 10
+
+
+//====================================================================================
+// Global variables
+//====================================================================================
+static const int xmaxs[3] = {71, 159, 335};
+static const int ymaxs[3] = {64, 129, 255};
+static const int vpairs[4] = {11, 22, 44, 66}; // data pairs of a line for each resolution (dai_vpairs)
+
+static uint8_t mode = MODE_DEFAULT, v16;
+static int xmax, ymax, npairs;
+static uint8_t palette[4] = {0, 5, 10, 15};
+static uint8_t dots[MAX_Y][MAX_X]; // DAI color of each dot, row 0 at bottom
+static uint8_t rows[MAX_Y][2 * MAX_PAIRS]; // data pairs in screen memory order
+static uint8_t img[HDR_SIZE + MAX_Y * (2 * MAX_PAIRS + MAX_PAIRS)];
+
+
+//====================================================================================
+// FUNCTIONS
+//====================================================================================
+
+static int set_mode(uint8_t m)
+{
+	if ((m >> 2) > 2) return 0;
+	mode = m;
+	v16 = ((m & 0x02) == 0);
+	xmax = xmaxs[m >> 2];
+	ymax = ymaxs[m >> 2];
+	npairs = (xmax + 1) / 8;
+	return 1;
+}
+
+// Dots from a PNG, 4 colors palette from the most used colors unless given
+static int from_png(const char *name, int keep)
+{
+	long count[16];
+	uint8_t all[16], *rgb;
+	int w, h, x, y, i, k, best;
+
+	rgb = png_read(name, &w, &h);
+	if (rgb == NULL) return 0;
+	for (i = 0; i < 16; i++) {
+		all[i] = i;
+		count[i] = 0;
+	}
+	for (y = 0; y <= ymax; y++) {
+		for (x = 0; x <= xmax; x++) {
+			i = ((long)(2 * (ymax - y) + 1) * h / (2 * (ymax + 1))) * w + (long)(2 * x + 1) * w / (2 * (xmax + 1));
+			dots[y][x] = dai_nearest(&rgb[i * 3], all, 16);
+			count[dots[y][x]]++;
+		}
+	}
+	free(rgb);
+	if (!keep) {
+		for (k = 0; k < 4; k++) { // most used first, unused colors keep their order
+			best = -1;
+			for (i = 0; i < 16; i++) if (count[i] >= 0 && (best < 0 || count[i] > count[best])) best = i;
+			palette[k] = best;
+			count[best] = -1;
+		}
+	}
+	return 1;
+}
+
+// Dots from screen memory addr to $BFFF
+static int from_dump(const uint8_t *mem, long addr)
+{
+	static const uint8_t *lines[MAX_Y * 4];
+	const uint8_t *r;
+	long a;
+	int n = 0, x, y, k;
+	uint8_t mb, res = mode >> 2, mk, p0, p1;
+
+	for (a = ROM_START - 1; a - 1 >= addr && n < (int)(sizeof(lines) / sizeof(lines[0]));) {
+		mb = mem[a - addr];
+		if ((mb & 0x40) == 0 && ((mb >> 4) & 0x03) == res && (mb >> 7) == v16) lines[n++] = &mem[a - addr];
+		a -= 2 + 2 * vpairs[(mb >> 4) & 0x03];
+	}
+	if (n <= ymax) return 0;
+	for (y = 0; y <= ymax; y++) {
+		r = lines[n - 1 - y]; // mode byte, row 0 is the last line
+		if (r - mem < 3 + 2 * npairs) return 0;
+		for (x = 0; x <= xmax; x++) {
+			if ((r[-1] & 0x40) == 0) { // unit color line
+				dots[y][x] = r[-1] & 0x0F;
+				continue;
+			}
+			k = (x + 8) >> 3;
+			mk = 0x80 >> ((x + 8) & 7);
+			p0 = r[-2 - 2 * k];
+			p1 = r[-3 - 2 * k];
+			if (v16) dots[y][x] = (p0 & mk) ? p1 >> 4 : p1 & 0x0F;
+			else dots[y][x] = palette[((p0 & mk) ? 1 : 0) | ((p1 & mk) ? 2 : 0)];
+		}
+	}
+	return 1;
+}
+
+// Data pairs of each row from the dots
+static void make_rows(void)
+{
+	uint8_t c[8], two[2], hi, lo, p0, p1;
+	int x, y, k, i, n0, n1, m;
+
+	for (y = 0; y <= ymax; y++) {
+		for (k = 0; k < npairs; k++) {
+			p0 = p1 = 0;
+			for (i = 0; i < 8; i++) {
+				c[i] = dots[y][k * 8 + i];
+				if (!v16) c[i] = dai_nearest(dai_rgb[c[i]], palette, 4);
+			}
+			if (v16) { // 2 most used colors, hi first
+				hi = c[0];
+				n0 = 0;
+				for (i = 0; i < 8; i++) {
+					for (m = 0, x = 0; x < 8; x++) m += (c[x] == c[i]);
+					if (m > n0 || (m == n0 && c[i] < hi)) {
+						n0 = m;
+						hi = c[i];
+					}
+				}
+				lo = hi;
+				n1 = 0;
+				for (i = 0; i < 8; i++) {
+					if (c[i] == hi) continue;
+					for (m = 0, x = 0; x < 8; x++) m += (c[x] == c[i]);
+					if (m > n1 || (m == n1 && c[i] < lo)) {
+						n1 = m;
+						lo = c[i];
+					}
+				}
+				two[0] = hi;
+				two[1] = lo;
+				for (i = 0; i < 8; i++) {
+					if (c[i] != hi && c[i] != lo) c[i] = two[dai_nearest(dai_rgb[c[i]], two, 2)];
+					if (c[i] == hi && hi != lo) p0 |= 0x80 >> i;
+				}
+				p1 = (hi << 4) | lo;
+			} else {
+				for (i = 0; i < 8; i++) {
+					if (c[i] & 1) p0 |= 0x80 >> i;
+					if (c[i] & 2) p1 |= 0x80 >> i;
+				}
+			}
+			rows[y][2 * k] = p0;
+			rows[y][2 * k + 1] = p1;
+		}
+	}
+}
+
+static int same_pair(const uint8_t *a, const uint8_t *b)
+{
+	return a[0] == b[0] && a[1] == b[1];
+}
+
+// Tokens of all rows after the header, returns the size of the image
+static int pack(void)
+{
+	uint8_t *o = img + HDR_SIZE, *lit = NULL;
+	int y, k, nc, nr;
+
+	img[0] = 'D';
+	img[1] = 'S';
+	img[2] = mode;
+	memcpy(&img[3], palette, 4);
+	img[7] = xmax & 0xFF;
+	img[8] = xmax >> 8;
+	img[9] = ymax;
+	for (y = 0; y <= ymax; y++) {
+		lit = NULL;
+		for (k = 0; k < npairs;) {
+			for (nc = 0; y > 0 && k + nc < npairs && nc < 128 && same_pair(&rows[y][2 * (k + nc)], &rows[y - 1][2 * (k + nc)]); nc++);
+			for (nr = 1; k + nr < npairs && nr < 64 && same_pair(&rows[y][2 * (k + nr)], &rows[y][2 * k]); nr++);
+			if (nc > 0 && nc >= nr) { // copy from the row below
+				*o++ = 0x80 | (nc - 1);
+				k += nc;
+				lit = NULL;
+			} else if (nr >= 2) { // repeated pair
+				*o++ = 0x40 | (nr - 1);
+				*o++ = rows[y][2 * k];
+				*o++ = rows[y][2 * k + 1];
+				k += nr;
+				lit = NULL;
+			} else { // one more pair in the current literal token
+				if (lit == NULL || *lit == 0x3F) {
+					lit = o++;
+					*lit = 0;
+				} else (*lit)++;
+				*o++ = rows[y][2 * k];
+				*o++ = rows[y][2 * k + 1];
+				k++;
+			}
+		}
+	}
+	return o - img;
+}
+
+// Rows from an image, same steps as dai_vunpack, returns 0 if the image is not valid
+static int unpack(const uint8_t *p, long n)
+{
+	const uint8_t *end = p + n;
+	int y, k, t, c, i;
+
+	if (n < HDR_SIZE || p[0] != 'D' || p[1] != 'S' || !set_mode(p[2])) return 0;
+	memcpy(palette, &p[3], 4);
+	if ((p[7] | (p[8] << 8)) != xmax || p[9] != ymax) return 0;
+	p += HDR_SIZE;
+	for (y = 0; y <= ymax; y++) {
+		for (k = 0; k < npairs;) {
+			if (p >= end) return 0;
+			t = *p++;
+			c = (t & (t & 0x80 ? 0x7F : 0x3F)) + 1;
+			if (k + c > npairs || (t >= 0x80 && y == 0)) return 0;
+			for (i = 0; i < c; i++, k++) {
+				if (t >= 0x80) memcpy(&rows[y][2 * k], &rows[y - 1][2 * k], 2);
+				else {
+					if (p + 2 > end) return 0;
+					memcpy(&rows[y][2 * k], p, 2);
+					if (t < 0x40) p += 2;
+				}
+			}
+			if (t >= 0x40 && t < 0x80) p += 2;
+		}
+	}
+	return 1;
+}
+
+static int show(const char *name)
+{
+	uint8_t *rgb = malloc((size_t)(xmax + 1) * (ymax + 1) * 3), p0, p1, mk, c;
+	int x, y, k, ok;
+
+	if (rgb == NULL) return 0;
+	for (y = 0; y <= ymax; y++) {
+		for (x = 0; x <= xmax; x++) {
+			k = x >> 3;
+			mk = 0x80 >> (x & 7);
+			p0 = rows[y][2 * k];
+			p1 = rows[y][2 * k + 1];
+			if (v16) c = (p0 & mk) ? p1 >> 4 : p1 & 0x0F;
+			else c = palette[((p0 & mk) ? 1 : 0) | ((p1 & mk) ? 2 : 0)];
+			memcpy(&rgb[((size_t)(ymax - y) * (xmax + 1) + x) * 3], dai_rgb[c], 3);
+		}
+	}
+	ok = png_write(name, rgb, xmax + 1, ymax + 1);
+	free(rgb);
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	static uint8_t file[65536 + 8];
+	unsigned c[4];
+	int i, n, keep = 0, x = 0;
+	FILE *f;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+			if (!set_mode(strtoul(argv[++i], NULL, 16))) break;
+		} else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+			if (sscanf(argv[++i], "%u,%u,%u,%u", &c[0], &c[1], &c[2], &c[3]) != 4) break;
+			for (n = 0; n < 4; n++) palette[n] = c[n] & 0x0F;
+			keep = 1;
+		} else if (strcmp(argv[i], "-x") == 0) x = 1;
+		else break;
+	}
+	if (argc - i != 2) {
+		fprintf(stderr, "usage: dai_scr [-m mode] [-p c0,c1,c2,c3] in.png|in.bin out.dsc\n"
+			"       dai_scr -x in.dsc out.png\n");
+		return 1;
+	}
+	set_mode(mode);
+	f = fopen(argv[i], "rb");
+	if (f == NULL) {
+		fprintf(stderr, "dai_scr: cannot read %s\n", argv[i]);
+		return 1;
+	}
+	n = fread(file, 1, sizeof(file), f);
+	fclose(f);
+
+	// Image to PNG
+	if (x) {
+		if (!unpack(file, n)) {
+			fprintf(stderr, "dai_scr: %s is not a valid image\n", argv[i]);
+			return 1;
+		}
+		if (!show(argv[i + 1])) {
+			fprintf(stderr, "dai_scr: cannot write %s\n", argv[i + 1]);
+			return 1;
+		}
+		return 0;
+	}
+
+	// PNG or screen memory to image
+	if (n >= 8 && memcmp(file, "\x89PNG", 4) == 0) {
+		if (!from_png(argv[i], keep)) {
+			fprintf(stderr, "dai_scr: cannot decode %s\n", argv[i]);
+			return 1;
+		}
+	} else if (n > ROM_START || !from_dump(file, ROM_START - n)) {
+		fprintf(stderr, "dai_scr: no screen of mode %02X in %s\n", mode, argv[i]);
+		return 1;
+	}
+	make_rows();
+	n = pack();
+	f = fopen(argv[i + 1], "wb");
+	if (f == NULL || fwrite(img, 1, n, f) != (size_t)n || fclose(f) != 0) {
+		fprintf(stderr, "dai_scr: cannot write %s\n", argv[i + 1]);
+		return 1;
+	}
+	printf("scr,%s,%02X,%d,%d,%d,%d\n", argv[i + 1], mode, xmax, ymax, (ymax + 1) * npairs * 2, n);
+	return 0;
+}
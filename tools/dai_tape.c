@@ -0,0 +1,649 @@
+//====================================================================================
+// dai_tape : host encoder and decoder of DAI cassette WAV files, turbo loader
+//====================================================================================
+// Writes a z88dk DAI binary (a.bin) as a WAV file for the UT R command of the DAI,
+// reads back such files, and checks the round trip on the host.
+//
+// Build (Linux) : cc -O2 -o dai_tape tools/dai_tape.c
+// Usage : dai_tape [options] a.bin a.wav   write a.bin to a.wav
+//         dai_tape -d a.wav [out.bin]      read a.wav, out.bin : last program found
+//         dai_tape -c [options] a.bin      write, read and compare in memory, both formats
+// -a addr : load address in hex (default 0800)
+// -n name : file name on the tape (default : name of a.bin in capitals)
+// -t      : turbo, a loader stub in ROM format followed by the program at about 3100 bauds
+// -s addr : stub address in hex (default : next page after the program)
+// -e addr : address run by the stub after the load (default : load address)
+// -g sec  : leader before the program, time to type the G command (default 5)
+// Exit code 0, 1 on error or when the check fails
+//
+// Output (stdout), one CSV record per line :
+// wav,<file>,<seconds>
+// file,<type>,<name>,<addr>,<length>,<ok|bad>,<start second>
+// turbo,<addr>,<length>,<ok|bad>,<start second>
+// check,<standard|turbo>,<seconds>,<ok|bad>
+//
+// ROM format, as in Fractale_Mandelbrot_UT_G800_Alt12.wav (44100 Hz, 8 bits) :
+// a cycle is a high half then a low half, short 13+13 samples or long 21+21 samples.
+// Leader of short cycles, then bits of 2 cycles : long short for 1, short long for 0.
+// Bits : 1 (sync), $55, file type ($31 binary), then blocks, MSB first :
+// length (2 bytes, high first), checksum, data, checksum.
+// Binary file : name block, address block (2 bytes, low first), program block.
+// Checksum : c = $56, then for each byte c = rlc(c xor byte).
+//
+// Turbo format : the stub is written in ROM format at -s, then a leader of short
+// cycles (5+5 samples), a long cycle (9+9 samples) and the program, one cycle per bit,
+// MSB first, followed by its checksum. On the DAI :
+// UT, R (play the tape), then G<stub address> during the leader : the stub measures
+// the leader, loads the program with interrupts disabled and runs it (G<entry>).
+// On a checksum error it prints ? and stops. Without remote control of the recorder,
+// the tape keeps playing while the G command is typed.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//====================================================================================
+// Definitions
+//====================================================================================
+#define ORG_DEFAULT 0x0800 // G0800 on the DAI
+#define ROM_START 0xC000
+#define RATE 44100
+#define LEVEL_HI 253 // 8 bits samples of the ROM format WAV
+#define LEVEL_LO 2
+#define STD_SHORT 13 // half cycles in samples
+#define STD_LONG 21
+#define STD_LEADER 3720 // short cycles, 2.2 seconds
+#define STD_TRAILER 64
+#define TB_SHORT 5
+#define TB_LONG 9
+#define TB_LEADER 256 // minimum, cycles
+#define MAX_FILES 8
+#define MIN_LEADER 128 // cycles
+
+// Stub offsets of values set by make_stub
+#define STUB_ADDR 0x2D
+#define STUB_ENDL 0x45
+#define STUB_ENDH 0x4B
+#define STUB_ENTRY 0x62
+
+typedef struct {
+	int turbo; // 0 : ROM format, 1 : turbo program
+	uint8_t type;
+	char name[64];
+	uint16_t addr;
+	uint8_t data[65536];
+	int len, ok;
+	double start; // seconds
+} tfile_t;
+
+
+//====================================================================================
+// Global variables
+//====================================================================================
+// Turbo loader, 8080 code (Z80 mnemonics), addresses relative to the stub
+static const uint8_t stub[] = {
+	0xF3,                      // 0000        di
+	0xCD, 0x6C, 0x00,          // 0001        call cyc ; wait for an edge
+	0x16, 0x08,                // 0004        ld d,8
+	0x1E, 0x00,                // 0006        ld e,0
+	0xCD, 0x6C, 0x00,          // 0008 cal:   call cyc ; e = length of 8 leader cycles
+	0x7B,                      // 000B        ld a,e
+	0x80,                      // 000C        add a,b
+	0x5F,                      // 000D        ld e,a
+	0x15,                      // 000E        dec d
+	0xC2, 0x08, 0x00,          // 000F        jp nz,cal
+	0x7B,                      // 0012        ld a,e
+	0x0F,                      // 0013        rrca
+	0x0F,                      // 0014        rrca
+	0x0F,                      // 0015        rrca
+	0xE6, 0x1F,                // 0016        and $1F
+	0x4F,                      // 0018        ld c,a ; e/8 : one short cycle
+	0x0F,                      // 0019        rrca
+	0x0F,                      // 001A        rrca
+	0xE6, 0x07,                // 001B        and $07
+	0x5F,                      // 001D        ld e,a
+	0x0F,                      // 001E        rrca
+	0xE6, 0x03,                // 001F        and $03
+	0x83,                      // 0021        add a,e
+	0x81,                      // 0022        add a,c
+	0x4F,                      // 0023        ld c,a ; c = threshold, 11/8 of a short cycle
+	0xCD, 0x6C, 0x00,          // 0024 sync:  call cyc
+	0x78,                      // 0027        ld a,b
+	0xB9,                      // 0028        cp c
+	0xDA, 0x24, 0x00,          // 0029        jp c,sync ; leader until the long sync cycle
+	0x21, 0x00, 0x00,          // 002C        ld hl,ADDR
+	0x1E, 0x56,                // 002F        ld e,$56 ; checksum
+	0x16, 0x01,                // 0031 byte:  ld d,1 ; end marker
+	0xCD, 0x6C, 0x00,          // 0033 bit:   call cyc
+	0x79,                      // 0036        ld a,c
+	0xB8,                      // 0037        cp b ; carry : long cycle, bit 1
+	0x7A,                      // 0038        ld a,d
+	0x17,                      // 0039        rla
+	0x57,                      // 003A        ld d,a
+	0xD2, 0x33, 0x00,          // 003B        jp nc,bit
+	0x77,                      // 003E        ld (hl),a
+	0xAB,                      // 003F        xor e
+	0x07,                      // 0040        rlca
+	0x5F,                      // 0041        ld e,a
+	0x23,                      // 0042        inc hl
+	0x7D,                      // 0043        ld a,l
+	0xFE, 0x00,                // 0044        cp END & $FF
+	0xC2, 0x31, 0x00,          // 0046        jp nz,byte
+	0x7C,                      // 0049        ld a,h
+	0xFE, 0x00,                // 004A        cp END >> 8
+	0xC2, 0x31, 0x00,          // 004C        jp nz,byte
+	0x16, 0x01,                // 004F        ld d,1
+	0xCD, 0x6C, 0x00,          // 0051 ckb:   call cyc
+	0x79,                      // 0054        ld a,c
+	0xB8,                      // 0055        cp b
+	0x7A,                      // 0056        ld a,d
+	0x17,                      // 0057        rla
+	0x57,                      // 0058        ld d,a
+	0xD2, 0x51, 0x00,          // 0059        jp nc,ckb
+	0xBB,                      // 005C        cp e
+	0xC2, 0x64, 0x00,          // 005D        jp nz,err
+	0xFB,                      // 0060        ei
+	0xC3, 0x00, 0x00,          // 0061        jp ENTRY
+	0xFB,                      // 0064 err:   ei
+	0x3E, 0x3F,                // 0065        ld a,'?'
+	0xEF,                      // 0067        rst 5
+	0x03,                      // 0068        defb $03 ; print a
+	0xC3, 0x69, 0x00,          // 0069 stop:  jp stop
+	0x06, 0x00,                // 006C cyc:   ld b,0 ; b = length of a cycle, 32 T states per count
+	0x04,                      // 006E cyh:   inc b
+	0x3A, 0x00, 0xFD,          // 006F        ld a,($FD00) ; bit 7 : tape input
+	0xA7,                      // 0072        and a
+	0xFA, 0x6E, 0x00,          // 0073        jp m,cyh
+	0x04,                      // 0076 cyl:   inc b
+	0x3A, 0x00, 0xFD,          // 0077        ld a,($FD00)
+	0xA7,                      // 007A        and a
+	0xF2, 0x76, 0x00,          // 007B        jp p,cyl
+	0xC9,                      // 007E        ret
+};
+// Offsets of addresses to relocate
+static const uint8_t stub_reloc[] = {2, 9, 16, 37, 42, 52, 60, 71, 77, 82, 90, 94, 106, 116, 124};
+
+// WAV being written
+static uint8_t *wav;
+static size_t nwav, capwav;
+
+// Decoder : lengths of cycles in samples at 44100 Hz, files found
+static double *cyc;
+static size_t ncyc;
+static tfile_t files[MAX_FILES];
+static int nfiles;
+
+
+//====================================================================================
+// FUNCTIONS
+//====================================================================================
+
+// -----------------------------------------------------------------------------------
+// Encoder
+// -----------------------------------------------------------------------------------
+static void put_level(int n, uint8_t v)
+{
+	if (nwav + n > capwav) {
+		capwav = (nwav + n) * 2;
+		wav = realloc(wav, capwav);
+		if (wav == NULL) {
+			fprintf(stderr, "dai_tape: out of memory\n");
+			exit(1);
+		}
+	}
+	memset(&wav[nwav], v, n);
+	nwav += n;
+}
+
+static void put_cycle(int half)
+{
+	put_level(half, LEVEL_HI);
+	put_level(half, LEVEL_LO);
+}
+
+static uint8_t checksum(const uint8_t *p, int n)
+{
+	uint8_t c = 0x56;
+
+	while (n-- > 0) {
+		c ^= *p++;
+		c = (c << 1) | (c >> 7);
+	}
+	return c;
+}
+
+static void put_std_byte(uint8_t v)
+{
+	int i;
+
+	for (i = 7; i >= 0; i--) {
+		put_cycle((v >> i) & 1 ? STD_LONG : STD_SHORT);
+		put_cycle((v >> i) & 1 ? STD_SHORT : STD_LONG);
+	}
+}
+
+static void put_std_block(const uint8_t *p, int n)
+{
+	uint8_t len[2];
+	int i;
+
+	len[0] = n >> 8;
+	len[1] = n & 0xFF;
+	put_std_byte(len[0]);
+	put_std_byte(len[1]);
+	put_std_byte(checksum(len, 2));
+	for (i = 0; i < n; i++) put_std_byte(p[i]);
+	put_std_byte(checksum(p, n));
+}
+
+// Binary file in ROM format
+static void put_std_file(const char *name, uint16_t addr, const uint8_t *p, int n)
+{
+	uint8_t a[2];
+	int i;
+
+	for (i = 0; i < STD_LEADER; i++) put_cycle(STD_SHORT);
+	put_cycle(STD_LONG); // sync bit
+	put_cycle(STD_SHORT);
+	put_std_byte(0x55);
+	put_std_byte(0x31);
+	put_std_block((const uint8_t *)name, strlen(name));
+	a[0] = addr & 0xFF;
+	a[1] = addr >> 8;
+	put_std_block(a, 2);
+	put_std_block(p, n);
+	for (i = 0; i < STD_TRAILER; i++) put_cycle(STD_SHORT);
+}
+
+// Program in turbo format, after gap seconds of leader
+static void put_turbo(const uint8_t *p, int n, double gap)
+{
+	uint8_t c = checksum(p, n);
+	long i, m = gap * RATE / (2 * TB_SHORT);
+	int b;
+
+	for (i = 0; i < (m > TB_LEADER ? m : TB_LEADER); i++) put_cycle(TB_SHORT);
+	put_cycle(TB_LONG); // sync
+	for (i = 0; i <= n; i++) {
+		for (b = 7; b >= 0; b--)
+			put_cycle((((i < n ? p[i] : c) >> b) & 1) ? TB_LONG : TB_SHORT);
+	}
+	put_cycle(TB_SHORT); // last edge
+	put_level(RATE / 10, 0x80);
+}
+
+static void make_stub(uint8_t *out, uint16_t at, uint16_t addr, uint16_t end, uint16_t entry)
+{
+	uint16_t w;
+	int i;
+
+	memcpy(out, stub, sizeof(stub));
+	for (i = 0; i < (int)sizeof(stub_reloc); i++) {
+		w = (out[stub_reloc[i]] | (out[stub_reloc[i] + 1] << 8)) + at;
+		out[stub_reloc[i]] = w & 0xFF;
+		out[stub_reloc[i] + 1] = w >> 8;
+	}
+	out[STUB_ADDR] = addr & 0xFF;
+	out[STUB_ADDR + 1] = addr >> 8;
+	out[STUB_ENDL] = end & 0xFF;
+	out[STUB_ENDH] = end >> 8;
+	out[STUB_ENTRY] = entry & 0xFF;
+	out[STUB_ENTRY + 1] = entry >> 8;
+}
+
+// Whole tape in wav, 0 if the program does not fit
+static int encode(const char *name, uint16_t addr, const uint8_t *p, int n, int turbo,
+	long at, long entry, double gap)
+{
+	uint8_t code[sizeof(stub)];
+	long end = addr + n;
+
+	nwav = 0;
+	if (n <= 0 || end > ROM_START) return 0;
+	if (!turbo) {
+		put_std_file(name, addr, p, n);
+		return 1;
+	}
+	if (at < 0) at = (end + 0xFF) & 0xFF00;
+	if (entry < 0) entry = addr;
+	if (at + (long)sizeof(stub) > ROM_START || (at < end && at + (long)sizeof(stub) > addr)) return 0;
+	make_stub(code, at, addr, end, entry);
+	put_std_file(name, at, code, sizeof(code));
+	put_turbo(p, n, gap);
+	return 1;
+}
+
+static int write_wav(const char *name)
+{
+	uint8_t h[44];
+	FILE *f;
+	int ok;
+
+	memcpy(h, "RIFF....WAVEfmt ", 16);
+	h[4] = (36 + nwav) & 0xFF; h[5] = (36 + nwav) >> 8; h[6] = (36 + nwav) >> 16; h[7] = (36 + nwav) >> 24;
+	h[16] = 16; h[17] = h[18] = h[19] = 0;
+	h[20] = 1; h[21] = 0; // PCM
+	h[22] = 1; h[23] = 0; // mono
+	h[24] = RATE & 0xFF; h[25] = RATE >> 8; h[26] = h[27] = 0;
+	h[28] = RATE & 0xFF; h[29] = RATE >> 8; h[30] = h[31] = 0; // bytes per second
+	h[32] = 1; h[33] = 0;
+	h[34] = 8; h[35] = 0;
+	memcpy(&h[36], "data", 4);
+	h[40] = nwav & 0xFF; h[41] = nwav >> 8; h[42] = nwav >> 16; h[43] = nwav >> 24;
+	f = fopen(name, "wb");
+	if (f == NULL) return 0;
+	ok = fwrite(h, 1, 44, f) == 44 && fwrite(wav, 1, nwav, f) == nwav;
+	return fclose(f) == 0 && ok;
+}
+
+
+// -----------------------------------------------------------------------------------
+// Decoder
+// -----------------------------------------------------------------------------------
+// Cycles from rising edge to rising edge of hi[] (1 : high level)
+static void cycles(const uint8_t *hi, size_t n, unsigned rate)
+{
+	size_t i, last = 0;
+	int started = 0;
+
+	free(cyc);
+	cyc = malloc((n / 2 + 1) * sizeof(double));
+	ncyc = 0;
+	if (cyc == NULL) return;
+	for (i = 1; i < n; i++) {
+		if (!hi[i] || hi[i - 1]) continue;
+		if (started) cyc[ncyc++] = (double)(i - last) * RATE / rate;
+		started = 1;
+		last = i;
+	}
+}
+
+static double cyc_start(size_t i)
+{
+	double t = 0;
+
+	while (i-- > 0) t += cyc[i];
+	return t / RATE;
+}
+
+// Next leader from cycle i : length of its short cycles, index after it in *j
+static double leader(size_t i, size_t *j)
+{
+	double sum;
+	size_t k;
+
+	for (; i + MIN_LEADER < ncyc; i++) {
+		sum = 0;
+		for (k = i; k < i + MIN_LEADER; k++) sum += cyc[k];
+		sum /= MIN_LEADER;
+		for (k = i; k < i + MIN_LEADER; k++)
+			if (cyc[k] < sum * 0.8 || cyc[k] > sum * 1.2) break;
+		if (k < i + MIN_LEADER) continue;
+		while (k < ncyc && cyc[k] >= sum * 0.8 && cyc[k] < sum * 11 / 8) k++;
+		if (k == ncyc || cyc[k] < sum * 0.8) { // next leader, shorter cycles
+			i = k - 1;
+			continue;
+		}
+		*j = k;
+		return sum;
+	}
+	return 0;
+}
+
+// ROM format file from the sync bit at cycle i, returns the index after it
+static size_t read_std(size_t i, double thr, tfile_t *f)
+{
+	static uint8_t b[65536 + 64];
+	int n = 0, nbits = 0, v = 0, p, len, blk = 0, l;
+
+	for (; i + 1 < ncyc; i += 2) {
+		if (cyc[i] > thr && cyc[i + 1] <= thr) v = (v << 1 | 1) & 0x1FF;
+		else if (cyc[i] <= thr && cyc[i + 1] > thr) v = (v << 1) & 0x1FF;
+		else break;
+		if (++nbits == 9) { // sync bit is the 9th bit of the first byte
+			if (n < (int)sizeof(b)) b[n++] = v & 0xFF;
+			nbits = 1;
+		}
+	}
+	f->turbo = 0;
+	f->type = n > 1 ? b[1] : 0;
+	f->name[0] = '\0';
+	f->addr = 0;
+	f->len = 0;
+	f->ok = n > 1 && b[0] == 0x55;
+	for (p = 2; p + 3 <= n; blk++) {
+		len = b[p] << 8 | b[p + 1];
+		if (checksum(&b[p], 2) != b[p + 2] || p + 4 + len > n) {
+			f->ok = 0;
+			break;
+		}
+		if (checksum(&b[p + 3], len) != b[p + 3 + len]) f->ok = 0;
+		if (blk == 0) {
+			l = len < (int)sizeof(f->name) ? len : (int)sizeof(f->name) - 1;
+			memcpy(f->name, &b[p + 3], l);
+			f->name[l] = '\0';
+		} else if (blk == 1 && f->type == 0x31 && len == 2) f->addr = b[p + 3] | (b[p + 4] << 8);
+		else {
+			if (f->len + len > (int)sizeof(f->data)) { // more data than the address space
+				f->ok = 0;
+				break;
+			}
+			memcpy(&f->data[f->len], &b[p + 3], len);
+			f->len += len;
+		}
+		p += 4 + len;
+	}
+	if (blk < 2) f->ok = 0;
+	return i;
+}
+
+// Turbo program from cycle i, after the sync cycle
+static size_t read_turbo(size_t i, double thr, tfile_t *f)
+{
+	int n = 0, nbits = 0, v = 0;
+
+	for (; i < ncyc && cyc[i] < thr * 2; i++) {
+		v = v << 1 | (cyc[i] > thr);
+		if (++nbits == 8) {
+			if (n < (int)sizeof(f->data)) f->data[n++] = v & 0xFF;
+			nbits = v = 0;
+		}
+	}
+	f->turbo = 1;
+	f->type = 0;
+	f->name[0] = '\0';
+	f->addr = 0;
+	f->len = n > 0 ? n - 1 : 0;
+	f->ok = n > 0 && checksum(f->data, f->len) == f->data[f->len];
+	return i;
+}
+
+// Address and length of a turbo program from the stub file before it
+static void turbo_addr(const tfile_t *s, tfile_t *f)
+{
+	uint8_t code[sizeof(stub)];
+	uint16_t addr, end;
+
+	if (s->turbo || s->len != sizeof(stub)) return;
+	addr = s->data[STUB_ADDR] | (s->data[STUB_ADDR + 1] << 8);
+	end = s->data[STUB_ENDL] | (s->data[STUB_ENDH] << 8);
+	make_stub(code, s->addr, addr, end, s->data[STUB_ENTRY] | (s->data[STUB_ENTRY + 1] << 8));
+	if (memcmp(code, s->data, sizeof(stub)) != 0) return;
+	f->addr = addr;
+	if (f->len != end - addr) f->ok = 0;
+}
+
+static void decode(const uint8_t *hi, size_t n, unsigned rate)
+{
+	size_t i = 0, j;
+	double s;
+	tfile_t *f;
+
+	cycles(hi, n, rate);
+	nfiles = 0;
+	while (nfiles < MAX_FILES && (s = leader(i, &j)) != 0 && j < ncyc) {
+		f = &files[nfiles++];
+		f->start = cyc_start(j);
+		if (s > (STD_SHORT + TB_LONG)) i = read_std(j, s * 11 / 8, f);
+		else {
+			i = read_turbo(j + 1, s * 11 / 8, f);
+			if (nfiles > 1) turbo_addr(&files[nfiles - 2], f);
+		}
+		if (f->len == 0 && f->name[0] == '\0') nfiles--; // tone without data
+	}
+}
+
+static uint8_t *read_wav(const char *name, size_t *n, unsigned *rate)
+{
+	uint8_t h[44], c[8], *s = NULL, *hi = NULL;
+	unsigned ch = 0, bits = 0, len, k;
+	size_t i, m = 0;
+	FILE *f = fopen(name, "rb");
+
+	if (f == NULL) return NULL;
+	if (fread(h, 1, 12, f) != 12 || memcmp(h, "RIFF", 4) != 0 || memcmp(&h[8], "WAVE", 4) != 0) goto end;
+	while (fread(c, 1, 8, f) == 8) {
+		len = c[4] | (c[5] << 8) | (c[6] << 16) | ((unsigned)c[7] << 24);
+		if (memcmp(c, "fmt ", 4) == 0 && len >= 16 && len <= sizeof(h)) {
+			if (fread(h, 1, len, f) != len) goto end;
+			ch = h[2] | (h[3] << 8);
+			*rate = h[4] | (h[5] << 8) | (h[6] << 16);
+			bits = h[14];
+			if (h[0] != 1 || ch == 0 || (bits != 8 && bits != 16)) goto end;
+		} else if (memcmp(c, "data", 4) == 0 && ch != 0) {
+			s = malloc(len);
+			if (s == NULL) goto end;
+			len = fread(s, 1, len, f);
+			k = ch * bits / 8;
+			hi = malloc(len / k + 1);
+			if (hi == NULL) goto end;
+			for (i = 0; i + k <= len; i += k, m++)
+				hi[m] = bits == 8 ? s[i] >= 0x80 : (int16_t)(s[i] | (s[i + 1] << 8)) >= 0;
+			break;
+		} else if (fseek(f, len + (len & 1), SEEK_CUR) != 0) goto end;
+	}
+end:
+	fclose(f);
+	free(s);
+	*n = m;
+	return hi;
+}
+
+
+// -----------------------------------------------------------------------------------
+// Round trip check of the tape in wav
+// -----------------------------------------------------------------------------------
+static int check(const char *mode, uint16_t addr, const uint8_t *p, int n, int turbo)
+{
+	uint8_t *hi = malloc(nwav);
+	tfile_t *f = &files[turbo];
+	size_t i;
+	int ok;
+
+	if (hi == NULL) return 0;
+	for (i = 0; i < nwav; i++) hi[i] = wav[i] >= 0x80;
+	decode(hi, nwav, RATE);
+	free(hi);
+	ok = nfiles == 1 + turbo && files[0].ok && f->ok && f->addr == addr && f->len == n
+		&& memcmp(f->data, p, n) == 0;
+	printf("check,%s,%.1f,%s\n", mode, (double)nwav / RATE, ok ? "ok" : "bad");
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	static uint8_t bin[65536];
+	char name[64], *opt_name = NULL;
+	const char *base, *out = NULL;
+	long at = -1, entry = -1;
+	uint16_t addr = ORG_DEFAULT;
+	int i, n, turbo = 0, dec = 0, chk = 0, ok;
+	double gap = 5;
+	unsigned rate = RATE;
+	uint8_t *hi;
+	size_t nhi;
+	FILE *f;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) addr = strtoul(argv[++i], NULL, 16);
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) opt_name = argv[++i];
+		else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) at = strtoul(argv[++i], NULL, 16);
+		else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) entry = strtoul(argv[++i], NULL, 16);
+		else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) gap = atof(argv[++i]);
+		else if (strcmp(argv[i], "-t") == 0) turbo = 1;
+		else if (strcmp(argv[i], "-d") == 0) dec = 1;
+		else if (strcmp(argv[i], "-c") == 0) chk = 1;
+		else break;
+	}
+	n = argc - i;
+	if ((dec && n != 1 && n != 2) || (chk && n != 1) || (!dec && !chk && n != 2) || (dec && chk)) {
+		fprintf(stderr, "usage: dai_tape [-a addr] [-n name] [-t] [-s addr] [-e addr] [-g sec] a.bin a.wav\n"
+			"       dai_tape -d a.wav [out.bin]\n"
+			"       dai_tape -c [-a addr] [-n name] [-s addr] [-e addr] [-g sec] a.bin\n");
+		return 1;
+	}
+
+	// Decoder
+	if (dec) {
+		hi = read_wav(argv[i], &nhi, &rate);
+		if (hi == NULL) {
+			fprintf(stderr, "dai_tape: cannot read %s\n", argv[i]);
+			return 1;
+		}
+		decode(hi, nhi, rate);
+		free(hi);
+		for (n = 0; n < nfiles; n++) {
+			if (files[n].turbo) printf("turbo,");
+			else printf("file,$%02X,%s,", files[n].type, files[n].name);
+			printf("$%04X,%d,%s,%.1f\n", files[n].addr, files[n].len, files[n].ok ? "ok" : "bad", files[n].start);
+		}
+		if (nfiles == 0) {
+			fprintf(stderr, "dai_tape: no file found in %s\n", argv[i]);
+			return 1;
+		}
+		if (argc - i == 2) {
+			f = fopen(argv[i + 1], "wb");
+			ok = f != NULL && fwrite(files[nfiles - 1].data, 1, files[nfiles - 1].len, f) == (size_t)files[nfiles - 1].len;
+			if (f == NULL || fclose(f) != 0 || !ok) {
+				fprintf(stderr, "dai_tape: cannot write %s\n", argv[i + 1]);
+				return 1;
+			}
+		}
+		return files[nfiles - 1].ok ? 0 : 1;
+	}
+
+	// Encoder
+	f = fopen(argv[i], "rb");
+	if (f == NULL) {
+		fprintf(stderr, "dai_tape: cannot read %s\n", argv[i]);
+		return 1;
+	}
+	n = fread(bin, 1, sizeof(bin), f);
+	fclose(f);
+	if (opt_name == NULL) {
+		base = strrchr(argv[i], '/');
+		base = base != NULL ? base + 1 : argv[i];
+		for (opt_name = name; *base != '\0' && opt_name < &name[sizeof(name) - 1]; base++)
+			*opt_name++ = (*base >= 'a' && *base <= 'z') ? *base - 'a' + 'A' : *base;
+		*opt_name = '\0';
+		opt_name = name;
+	}
+	if (chk) {
+		ok = encode(opt_name, addr, bin, n, 0, at, entry, gap) && check("standard", addr, bin, n, 0);
+		ok = encode(opt_name, addr, bin, n, 1, at, entry, gap) && check("turbo", addr, bin, n, 1) && ok;
+		return ok ? 0 : 1;
+	}
+	out = argv[i + 1];
+	if (!encode(opt_name, addr, bin, n, turbo, at, entry, gap)) {
+		fprintf(stderr, "dai_tape: %s and the stub do not fit in memory at $%04X\n", argv[i], addr);
+		return 1;
+	}
+	if (!write_wav(out)) {
+		fprintf(stderr, "dai_tape: cannot write %s\n", out);
+		return 1;
+	}
+	printf("wav,%s,%.1f\n", out, (double)nwav / RATE);
+	return 0;
+}